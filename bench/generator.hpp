@@ -0,0 +1,149 @@
+#pragma once
+
+#include <climits>
+#include <random>
+#include <string>
+
+#include "graph_factory.hpp"
+
+// Parameters of a synthetic assembly
+struct AssemblySpec
+{
+    // Number of atomic parts, the root subassembly contains all of them
+    std::size_t parts = 8;
+    // Number of agents available for the assignment
+    std::size_t agents = 3;
+    // Maximum number of alternative actions per subassembly
+    std::size_t alternatives = 2;
+    // Probability that a subassembly is not reachable by an agent
+    double unreachable = 0.1;
+    // Probability that an agent cannot perform an action at all [inf]
+    double infeasible = 0.1;
+    unsigned seed = 42;
+};
+
+// Generates AND/OR graphs of the same shape as the hand-written example assemblies.
+// Parts are named 'A', 'B', ..., every subassembly is named after the contiguous range of parts it
+// contains, and every action splits a subassembly into two smaller ones. Subassemblies shared between
+// alternatives are only created once, so the result is a DAG as produced by the IoXml.
+struct AssemblyGenerator
+{
+    AssemblyGenerator(const AssemblySpec &);
+
+    void generate(Graph<AssemblyData, EdgeData> &, config::Configuration &);
+
+  private:
+    Symbol subassembly(std::size_t, std::size_t);
+    config::Action costs(Symbol);
+    std::unordered_map<Symbol, config::Reach> reachability();
+
+    AssemblySpec spec_;
+    std::mt19937 rng_;
+    GraphFactory *factory_ = nullptr;
+    config::Configuration *config_ = nullptr;
+    std::size_t action_ctr_ = 0;
+    std::size_t interaction_ctr_ = 0;
+};
+
+inline AssemblyGenerator::AssemblyGenerator(const AssemblySpec &spec)
+    : spec_(spec), rng_(spec.seed)
+{}
+
+inline void AssemblyGenerator::generate(Graph<AssemblyData, EdgeData> &graph, config::Configuration &config)
+{
+    GraphFactory factory(&graph);
+    factory_ = &factory;
+    config_ = &config;
+    action_ctr_ = 0;
+    interaction_ctr_ = 0;
+
+    for (std::size_t i = 0; i < spec_.agents; i++)
+    {
+        config::Agent agent;
+        agent.name = intern("r" + std::to_string(i + 1));
+        agent.hostname = "localhost";
+        agent.port = std::to_string(9000 + i);
+        config.agents[agent.name] = agent;
+    }
+
+    auto root = subassembly(0, spec_.parts);
+    factory.setRoot(root);
+
+    factory_ = nullptr;
+    config_ = nullptr;
+}
+
+// Create the subassembly containing the parts [begin, end) together with all actions disassembling it.
+//   \return: name of the subassembly
+//
+inline Symbol AssemblyGenerator::subassembly(std::size_t begin, std::size_t end)
+{
+    std::string parts;
+    for (std::size_t i = begin; i < end; i++)
+        parts += static_cast<char>('A' + i);
+
+    Symbol name = intern(parts);
+    if (factory_->id_map.count(name))
+        return name;
+
+    factory_->insertOr(name);
+    config_->subassemblies[name].name = name;
+    config_->subassemblies[name].reachability = reachability();
+
+    std::size_t length = end - begin;
+    if (length < 2)
+        return name;
+
+    // Split points are spread around the middle of the range
+    std::size_t alternatives = std::min(spec_.alternatives, length - 1);
+    for (std::size_t k = 0; k < alternatives; k++)
+    {
+        long offset = static_cast<long>((k + 1) / 2) * ((k % 2) ? 1 : -1);
+        long middle = static_cast<long>(begin + length / 2);
+        std::size_t split = std::clamp<long>(middle + offset, begin + 1, end - 1);
+
+        Symbol action = intern("a" + std::to_string(++action_ctr_));
+        factory_->insertAnd(action);
+        config_->actions[action] = costs(action);
+
+        factory_->insertEdge(name, action);
+        factory_->insertEdge(action, subassembly(begin, split));
+        factory_->insertEdge(action, subassembly(split, end));
+    }
+    return name;
+}
+
+inline config::Action AssemblyGenerator::costs(Symbol name)
+{
+    std::uniform_int_distribution<int> cost(5, 50);
+    std::bernoulli_distribution infeasible(spec_.infeasible);
+
+    config::Action action;
+    action.name = name;
+    for (const auto &agent : config_->agents)
+        action.costs[agent.first] = infeasible(rng_) ? INT_MAX : cost(rng_);
+    return action;
+}
+
+inline std::unordered_map<Symbol, config::Reach> AssemblyGenerator::reachability()
+{
+    std::bernoulli_distribution unreachable(spec_.unreachable);
+
+    std::unordered_map<Symbol, config::Reach> reach_map;
+    for (const auto &agent : config_->agents)
+    {
+        config::Reach reach;
+        reach.reachable = !unreachable(rng_);
+        if (reach.reachable)
+        {
+            reach.interaction.name = intern("-");
+        }
+        else
+        {
+            reach.interaction = costs(intern("i" + std::to_string(interaction_ctr_++)));
+            config_->actions[reach.interaction.name] = reach.interaction;
+        }
+        reach_map[agent.first] = reach;
+    }
+    return reach_map;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal timing harness used by the `planner_bench` target.
+// Every benchmark is sampled several times; each sample measures only the region
+// enclosed by `Stopwatch::start()`/`Stopwatch::stop()`, so setup work can be excluded.
+
+struct Stopwatch
+{
+    using Clock = std::chrono::steady_clock;
+
+    void start();
+    void stop();
+
+    // Accumulated nanoseconds of all start/stop pairs of the current sample
+    double elapsed_ns = 0;
+
+  private:
+    Clock::time_point begin_;
+};
+
+inline void Stopwatch::start()
+{
+    begin_ = Clock::now();
+}
+
+inline void Stopwatch::stop()
+{
+    elapsed_ns += std::chrono::duration<double, std::nano>(Clock::now() - begin_).count();
+}
+
+// Summary of the samples collected for a single benchmark
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t samples = 0;
+    // Number of processed items per sample, used to derive the throughput
+    std::size_t items = 0;
+
+    double min = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+struct BenchmarkRunner
+{
+    BenchmarkRunner(std::size_t samples, std::size_t warmup, std::string filter);
+
+    // Run benchmark `fn` if its name matches the filter.
+    //   @name:  unique benchmark name, segments separated by '/'
+    //   @items: items processed per sample (e.g. inserted nodes)
+    //   @fn:    callable timing a single sample using the passed stopwatch
+    //
+    void run(const std::string &name, std::size_t items, const std::function<void(Stopwatch &)> &fn);
+
+    // Write all results as JSON to the given stream
+    void writeJson(std::ostream &) const;
+    // Print a human readable table to the given stream
+    void print(std::ostream &) const;
+
+  private:
+    static double percentile(const std::vector<double> &, double);
+
+    std::size_t samples_;
+    std::size_t warmup_;
+    std::string filter_;
+    std::vector<BenchmarkResult> results_;
+};
+
+inline BenchmarkRunner::BenchmarkRunner(std::size_t samples, std::size_t warmup, std::string filter)
+    : samples_(samples), warmup_(warmup), filter_(filter)
+{}
+
+inline void BenchmarkRunner::run(const std::string &name, std::size_t items,
+                                 const std::function<void(Stopwatch &)> &fn)
+{
+    if (!filter_.empty() && name.find(filter_) == std::string::npos)
+        return;
+
+    for (std::size_t i = 0; i < warmup_; i++)
+    {
+        Stopwatch sw;
+        fn(sw);
+    }
+
+    std::vector<double> times;
+    times.reserve(samples_);
+    for (std::size_t i = 0; i < samples_; i++)
+    {
+        Stopwatch sw;
+        fn(sw);
+        times.push_back(sw.elapsed_ns);
+    }
+    std::sort(times.begin(), times.end());
+
+    BenchmarkResult r;
+    r.name = name;
+    r.samples = times.size();
+    r.items = items;
+    r.min = times.front();
+    r.max = times.back();
+    double sum = 0;
+    for (auto t : times)
+        sum += t;
+    r.mean = sum / times.size();
+    r.p50 = percentile(times, 0.50);
+    r.p90 = percentile(times, 0.90);
+    r.p99 = percentile(times, 0.99);
+    results_.push_back(r);
+
+    std::cerr << "  " << std::left << std::setw(48) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << r.p50 << " ns" << std::endl;
+}
+
+// Nearest-rank percentile of a sorted sample vector
+inline double BenchmarkRunner::percentile(const std::vector<double> &sorted, double p)
+{
+    std::size_t rank = static_cast<std::size_t>(p * sorted.size() + 0.999999);
+    rank = std::clamp<std::size_t>(rank, 1, sorted.size());
+    return sorted[rank - 1];
+}
+
+inline void BenchmarkRunner::writeJson(std::ostream &os) const
+{
+    os << std::fixed << std::setprecision(1);
+    os << "{" << std::endl;
+    os << "  \"unit\": \"ns\"," << std::endl;
+    os << "  \"benchmarks\": [" << std::endl;
+    for (std::size_t i = 0; i < results_.size(); i++)
+    {
+        const auto &r = results_[i];
+        double throughput = r.p50 > 0 ? r.items / (r.p50 * 1e-9) : 0;
+        os << "    {"
+           << "\"name\": \"" << r.name << "\", "
+           << "\"samples\": " << r.samples << ", "
+           << "\"items\": " << r.items << ", "
+           << "\"min\": " << r.min << ", "
+           << "\"mean\": " << r.mean << ", "
+           << "\"p50\": " << r.p50 << ", "
+           << "\"p90\": " << r.p90 << ", "
+           << "\"p99\": " << r.p99 << ", "
+           << "\"max\": " << r.max << ", "
+           << "\"items_per_second\": " << throughput << "}"
+           << (i + 1 < results_.size() ? "," : "") << std::endl;
+    }
+    os << "  ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+inline void BenchmarkRunner::print(std::ostream &os) const
+{
+    os << std::left << std::setw(48) << "benchmark" << std::right
+       << std::setw(14) << "p50 [ns]" << std::setw(14) << "p90 [ns]"
+       << std::setw(14) << "p99 [ns]" << std::setw(16) << "items/s" << std::endl;
+    os << std::fixed << std::setprecision(0);
+    for (const auto &r : results_)
+    {
+        double throughput = r.p50 > 0 ? r.items / (r.p50 * 1e-9) : 0;
+        os << std::left << std::setw(48) << r.name << std::right
+           << std::setw(14) << r.p50 << std::setw(14) << r.p90
+           << std::setw(14) << r.p99 << std::setw(16) << throughput << std::endl;
+    }
+}
@@ -0,0 +1,372 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "planner.hpp"
+#include "replanner.hpp"
+#include "generator.hpp"
+#include "harness.hpp"
+
+// Discards everything written to it, used to silence the planner output while timing.
+struct NullBuffer : std::streambuf
+{
+    int overflow(int c) override { return c; }
+};
+
+// Select up to `width` open subassemblies by repeatedly applying the first action of the
+// subassembly closest to the root. Used to create realistic hypernodes for the expander.
+static SearchData openState(Graph<AssemblyData, EdgeData> &graph, std::size_t width)
+{
+    std::vector<NodeIndex> open{graph.root->id};
+    while (open.size() < width)
+    {
+        auto it = std::find_if(open.begin(), open.end(),
+                               [&](NodeIndex id) { return graph.hasSuccessor(id); });
+        if (it == open.end())
+            break;
+        auto action = graph.successorNodes(*it).front();
+        open.erase(it);
+        for (auto child : graph.successorNodes(action))
+            open.push_back(child);
+    }
+
+    SearchData state;
+    for (auto id : open)
+    {
+        state.subassemblies.set(graph.getNodeData(id).name, id);
+        state.hash ^= graph.getNodeData(id).key;
+        for (auto action : graph.successorNodes(id))
+        {
+            state.actions.set(graph.getNodeData(action).name, action);
+            state.hash ^= graph.getNodeData(action).key;
+        }
+    }
+    return state;
+}
+
+static void benchGraph(BenchmarkRunner &runner)
+{
+    for (std::size_t n : {1000, 10000, 100000})
+    {
+        runner.run("graph/insert_node/n=" + std::to_string(n), n, [n](Stopwatch &sw) {
+            Graph<AssemblyData, EdgeData> graph;
+            AssemblyData data;
+            data.type = NodeType::SUBASSEMBLY;
+            sw.start();
+            for (std::size_t i = 0; i < n; i++)
+                graph.insertNode(data);
+            sw.stop();
+        });
+
+        runner.run("graph/insert_edge/n=" + std::to_string(n), n, [n](Stopwatch &sw) {
+            Graph<AssemblyData, EdgeData> graph;
+            for (std::size_t i = 0; i <= n; i++)
+                graph.insertNode(AssemblyData());
+            sw.start();
+            for (std::size_t i = 0; i < n; i++)
+                graph.insertEdge(EdgeData(), i / 2, i + 1);
+            sw.stop();
+        });
+
+        // Binary tree, every node except the root is visited once as a successor
+        Graph<AssemblyData, EdgeData> tree;
+        for (std::size_t i = 0; i <= n; i++)
+            tree.insertNode(AssemblyData());
+        for (std::size_t i = 0; i < n; i++)
+            tree.insertEdge(EdgeData(), i / 2, i + 1);
+
+        runner.run("graph/successor_nodes/n=" + std::to_string(n), n, [&tree, n](Stopwatch &sw) {
+            std::size_t visited = 0;
+            sw.start();
+            for (std::size_t i = 0; i <= n; i++)
+                for (auto succ : tree.successorNodes(i))
+                    visited += succ;
+            sw.stop();
+            if (visited == 0)
+                std::cerr << "unexpected empty graph" << std::endl;
+        });
+    }
+}
+
+static void benchCombinator(BenchmarkRunner &runner)
+{
+    for (std::size_t agents : {2, 3, 4})
+    {
+        for (std::size_t width : {1, 2, 3, 4})
+        {
+            // `width` open subassemblies, each offering two alternative actions
+            Graph<AssemblyData, EdgeData> graph;
+            GraphFactory factory(&graph);
+            std::vector<NodeIndex> nodes;
+            for (std::size_t i = 0; i < width; i++)
+            {
+                auto sa = intern("s" + std::to_string(i));
+                nodes.push_back(factory.insertOr(sa));
+                for (std::size_t k = 0; k < 2; k++)
+                {
+                    auto action = intern(nameOf(sa) + "a" + std::to_string(k));
+                    factory.insertAnd(action);
+                    factory.insertEdge(sa, action);
+                }
+            }
+            config::Configuration config;
+            for (std::size_t i = 0; i < agents; i++)
+            {
+                auto agent = intern("r" + std::to_string(i));
+                config.agents[agent].name = agent;
+            }
+
+            Combinator combinator(config);
+            auto items = combinator.generateAgentActionAssignments(graph, nodes).size();
+
+            auto name = "combinator/assignments/agents=" + std::to_string(agents) +
+                        "/subassemblies=" + std::to_string(width);
+            runner.run(name, items, [&](Stopwatch &sw) {
+                sw.start();
+                auto result = combinator.generateAgentActionAssignments(graph, nodes);
+                sw.stop();
+                if (result.size() != items)
+                    std::cerr << "unexpected number of assignments" << std::endl;
+            });
+
+            // Cost of the cheapest assignment of every size, which is all a partial expansion needs first
+            name = "combinator/ranked_first/agents=" + std::to_string(agents) +
+                   "/subassemblies=" + std::to_string(width);
+            runner.run(name, 1, [&](Stopwatch &sw) {
+                sw.start();
+                RankedCombinator ranked(graph, config, nodes);
+                auto result = ranked.next();
+                sw.stop();
+                if (result.empty())
+                    std::cerr << "unexpected empty assignment" << std::endl;
+            });
+        }
+    }
+}
+
+static void benchExpander(BenchmarkRunner &runner)
+{
+    for (std::size_t agents : {2, 3})
+    {
+        for (std::size_t width : {1, 2, 4})
+        {
+            AssemblySpec spec;
+            spec.parts = 12;
+            spec.agents = agents;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+            auto state = openState(assembly, width);
+
+            // Count the generated hypernodes once to report the throughput
+            std::size_t items = 0;
+            {
+                auto graph = assembly;
+                SearchTree search_tree;
+                auto id = search_tree.insertRoot(state);
+                NodeExpander expander(graph, search_tree, config);
+                auto children = expander.expandNode(id);
+                items = children.second - children.first;
+            }
+
+            auto name = "expander/expand_node/agents=" + std::to_string(agents) +
+                        "/subassemblies=" + std::to_string(state.subassemblies.size());
+            runner.run(name, items, [&](Stopwatch &sw) {
+                // The expander inserts interactions into the assembly, so every sample uses a fresh copy
+                auto graph = assembly;
+                SearchTree search_tree;
+                auto id = search_tree.insertRoot(state);
+                NodeExpander expander(graph, search_tree, config);
+                sw.start();
+                expander.expandNode(id);
+                sw.stop();
+            });
+        }
+    }
+}
+
+static void benchOpenList(BenchmarkRunner &runner)
+{
+    // Scores shaped like the search: averaged integer costs plus a fractional heuristic
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> cost(5, 50);
+    std::vector<OpenEntry> entries;
+    for (std::size_t i = 0; i < 100000; i++)
+    {
+        double g = cost(rng) / 2.0;
+        entries.push_back(OpenEntry{g + std::log2(cost(rng)), g, i});
+    }
+
+    for (auto type : {OpenListType::DARY_HEAP, OpenListType::BUCKET})
+    {
+        auto name = std::string("openlist/push_pop/") +
+                    (type == OpenListType::BUCKET ? "bucket" : "dary_heap");
+        runner.run(name, entries.size(), [&](Stopwatch &sw) {
+            auto open = makeOpenList(type);
+            sw.start();
+            for (const auto &entry : entries)
+                open->push(entry);
+            while (!open->empty())
+                open->pop();
+            sw.stop();
+        });
+    }
+}
+
+static void benchPlanner(BenchmarkRunner &runner)
+{
+    NullBuffer null_buffer;
+    for (std::size_t parts : {4, 5, 6})
+    {
+        for (std::size_t agents : {2, 3})
+        {
+            AssemblySpec spec;
+            spec.parts = parts;
+            spec.agents = agents;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+
+            auto name = "planner/end_to_end/parts=" + std::to_string(parts) +
+                        "/agents=" + std::to_string(agents);
+            runner.run(name, 1, [&](Stopwatch &sw) {
+                auto buffer = std::cout.rdbuf(&null_buffer);
+                Planner planner;
+                sw.start();
+                auto plan = planner(assembly, config);
+                sw.stop();
+                std::cout.rdbuf(buffer);
+            });
+        }
+    }
+}
+
+static void benchDecomposition(BenchmarkRunner &runner)
+{
+    NullBuffer null_buffer;
+    for (std::size_t parts : {8, 12, 16})
+    {
+        AssemblySpec spec;
+        spec.parts = parts;
+        spec.agents = 3;
+        Graph<AssemblyData, EdgeData> assembly;
+        config::Configuration config;
+        AssemblyGenerator(spec).generate(assembly, config);
+
+        PlannerOptions options;
+        options.decompose = true;
+        options.decompose_threshold = 8;
+
+        runner.run("planner/decompose/parts=" + std::to_string(parts), 1, [&](Stopwatch &sw) {
+            auto buffer = std::cout.rdbuf(&null_buffer);
+            Planner planner(options);
+            sw.start();
+            auto plan = planner(assembly, config);
+            sw.stop();
+            std::cout.rdbuf(buffer);
+        });
+    }
+}
+
+static void benchAOStar(BenchmarkRunner &runner)
+{
+    for (std::size_t parts : {8, 16, 32})
+    {
+        AssemblySpec spec;
+        spec.parts = parts;
+        spec.agents = 3;
+        Graph<AssemblyData, EdgeData> assembly;
+        config::Configuration config;
+        AssemblyGenerator(spec).generate(assembly, config);
+
+        runner.run("planner/aostar/parts=" + std::to_string(parts), 1, [&](Stopwatch &sw) {
+            sw.start();
+            AOStarSolver solver(assembly, config);
+            auto plan = solver.solve();
+            sw.stop();
+        });
+    }
+}
+
+static void benchReplanner(BenchmarkRunner &runner)
+{
+    for (std::size_t parts : {5, 6})
+    {
+        AssemblySpec spec;
+        spec.parts = parts;
+        spec.agents = 3;
+        Graph<AssemblyData, EdgeData> assembly;
+        config::Configuration config;
+        AssemblyGenerator(spec).generate(assembly, config);
+
+        // An agent of the first round of the initial plan becomes twice as slow for its action
+        runner.run("planner/replan/parts=" + std::to_string(parts), 1, [&](Stopwatch &sw) {
+            Replanner replanner(assembly, config);
+            auto plan = replanner.plan();
+            const auto &first = plan.rounds.front().front();
+            ConfigurationDelta delta;
+            delta.costs.push_back({first.action, first.agent, 2 * config.actions[first.action].costs[first.agent]});
+            sw.start();
+            plan = replanner.update(delta);
+            sw.stop();
+        });
+    }
+}
+
+static void usage()
+{
+    std::cout << "Usage: planner_bench [--json <file>] [--filter <substring>]"
+              << " [--samples <n>] [--warmup <n>]" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string json_path;
+    std::string filter;
+    std::size_t samples = 20;
+    std::size_t warmup = 2;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--json")
+            json_path = argv[++i];
+        else if (i + 1 < argc && arg == "--filter")
+            filter = argv[++i];
+        else if (i + 1 < argc && arg == "--samples")
+            samples = std::max(1, std::stoi(argv[++i]));
+        else if (i + 1 < argc && arg == "--warmup")
+            warmup = std::max(0, std::stoi(argv[++i]));
+        else
+        {
+            usage();
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    BenchmarkRunner runner(samples, warmup, filter);
+    benchGraph(runner);
+    benchCombinator(runner);
+    benchExpander(runner);
+    benchOpenList(runner);
+    benchPlanner(runner);
+    benchDecomposition(runner);
+    benchAOStar(runner);
+    benchReplanner(runner);
+
+    if (json_path.empty())
+    {
+        runner.print(std::cout);
+    }
+    else
+    {
+        std::ofstream fs(json_path);
+        if (!fs)
+        {
+            std::cerr << "ERROR: Could not open " << json_path << std::endl;
+            return 1;
+        }
+        runner.writeJson(fs);
+    }
+    return 0;
+}
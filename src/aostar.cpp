@@ -0,0 +1,109 @@
+#include "aostar.hpp"
+
+AOStarSolver::AOStarSolver(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                           SearchStatistics* stats)
+  : graph_(graph),
+    config_(config),
+    stats_(stats ? stats : &own_stats_)
+{}
+
+// Plan the subassembly at the root of the graph
+//   \return: plan with the minimum total action cost, rooted at the root of the graph
+//
+AssemblyPlan AOStarSolver::solve()
+{
+    TRACE_SCOPE("AOStarSolver::solve", "search");
+
+    evaluate(graph_.root->id);
+    return extract(graph_.root->id);
+}
+
+double AOStarSolver::cost(NodeIndex subassembly)
+{
+    return evaluate(subassembly).cost;
+}
+
+double AOStarSolver::cost(NodeIndex subassembly, Symbol agent)
+{
+    return evaluate(subassembly).consumed.at(agent);
+}
+
+// Fill the table entry of a subassembly, evaluating its children first.
+// Subassemblies on a cycle of the graph are infeasible and keep an infinite cost.
+const AOStarSolver::Entry& AOStarSolver::evaluate(NodeIndex id)
+{
+    auto it = table_.find(id);
+    if (it != table_.end())
+        return it->second;
+
+    auto& entry = table_[id];
+    entry.evaluating = true;
+    stats_->nodes_generated++;
+
+    auto actions = graph_.successorNodes(id);
+    if (actions.empty())
+        entry.cost = 0;
+
+    for (auto action_id : actions)
+    {
+        const auto& action = config_.actions.at(graph_.getNodeData(action_id).name);
+        auto children = graph_.successorNodes(action_id);
+
+        bool cyclic = false;
+        for (auto child : children)
+            cyclic |= table_.count(child) && table_.at(child).evaluating;
+        if (cyclic)
+            continue;
+
+        std::vector<const Entry*> child_entries;
+        for (auto child : children)
+            child_entries.push_back(&evaluate(child));
+
+        for (const auto& agent : config_.agents)
+        {
+            stats_->assignments_enumerated++;
+            double cost = action.costs.at(agent.first);
+            for (auto child : child_entries)
+                cost += child->consumed.at(agent.first);
+            if (cost < entry.cost)
+            {
+                entry.cost = cost;
+                entry.action = action_id;
+                entry.agent = agent.first;
+            }
+        }
+    }
+
+    const auto& name = graph_.getNodeData(id).name;
+    for (const auto& agent : config_.agents)
+    {
+        auto i = cheapestInteraction(config_, name, agent.first);
+        entry.consumed[agent.first] = entry.cost + (i.first ? i.first->costs.at(i.second) : 0);
+    }
+    entry.evaluating = false;
+    stats_->nodes_expanded++;
+    return entry;
+}
+
+// Build the plan of a subassembly from the choices stored in the table
+const AssemblyPlan& AOStarSolver::extract(NodeIndex id)
+{
+    auto it = plans_.find(id);
+    if (it != plans_.end())
+        return it->second;
+
+    const auto& entry = table_.at(id);
+    AssemblyPlan plan;
+    if (graph_.hasSuccessor(id) && entry.cost < INFINITY)
+    {
+        std::vector<const AssemblyPlan*> child_plans;
+        for (auto child : graph_.successorNodes(entry.action))
+            child_plans.push_back(&extract(child));
+        plan = composePlan(graph_, config_, id, entry.action, entry.agent, child_plans);
+    }
+    else
+    {
+        plan.graph.root = plan.graph.getNode(plan.graph.insertNode(graph_.getNodeData(id)));
+    }
+    return plans_.emplace(id, std::move(plan)).first->second;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+#include "plan.hpp"
+#include "statistics.hpp"
+#include "trace.hpp"
+#include "types.hpp"
+
+// Exact solver for the total action cost, using memoized dynamic programming over the AND/OR graph.
+// The cost of a subassembly is the cheapest combination of an action, its agent and the costs of the
+// action's children. A child costs its own optimum plus, if the agent cannot reach it, the cheapest
+// interaction handing it over. This is AO* with every node evaluated exactly once: the cost table
+// holds one entry per subassembly and per consuming agent, so the solver runs in
+// O((subassemblies + actions) * agents) on trees and never touches the combinatorial hypernode space.
+//
+// The solver minimizes the sum of all action costs, while the A* search minimizes the sum of the
+// mean action cost per round. The rounds of the returned plan are a valid A* solution, so its
+// `roundCost` is an upper bound on the A* optimum and can be used to warm-start the search.
+class AOStarSolver
+{
+  public:
+    AOStarSolver(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchStatistics* stats = nullptr);
+
+    // Plan the subassembly at the root of the graph
+    AssemblyPlan solve();
+
+    // Optimal total cost of a subassembly, without any interaction to hand it over
+    double cost(NodeIndex subassembly);
+    // Optimal total cost of a subassembly consumed by an action of the given agent
+    double cost(NodeIndex subassembly, Symbol agent);
+
+  private:
+    struct Entry
+    {
+        double cost = INFINITY;
+        NodeIndex action = 0;
+        Symbol agent = 0;
+        // Cost including the interaction, per agent consuming the subassembly
+        std::unordered_map<Symbol, double> consumed;
+        bool evaluating = false;
+    };
+
+    const Entry& evaluate(NodeIndex);
+    const AssemblyPlan& extract(NodeIndex);
+
+    Graph<AssemblyData,EdgeData>& graph_;
+    config::Configuration& config_;
+    SearchStatistics own_stats_;
+    SearchStatistics* stats_;
+
+    std::unordered_map<NodeIndex, Entry> table_;
+    std::unordered_map<NodeIndex, AssemblyPlan> plans_;
+};
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <unordered_map>
+
+#include "assemblyplanner.h"
+#include "io.hpp"
+#include "planner.hpp"
+
+struct ap_model
+{
+    Graph<AssemblyData,EdgeData> graph;
+    config::Configuration config;
+};
+
+struct ap_result
+{
+    PlanningStatus status;
+    std::vector<ap_plan_info> plans;
+    // Actions of every plan, their strings point into the process-wide symbol table
+    std::vector<std::vector<ap_action>> actions;
+};
+
+// Layout of the first version of `ap_options`, every caller passes at least these options
+static constexpr size_t ap_options_base_size = offsetof(ap_options, suboptimality);
+
+static ap_options defaultOptions()
+{
+    PlannerOptions defaults;
+    ap_options options;
+    options.struct_size = sizeof(ap_options);
+    options.solver = AP_SOLVER_ASTAR;
+    options.prune = defaults.prune;
+    options.partial_expansion = defaults.partial_expansion;
+    options.decompose = defaults.decompose;
+    options.decompose_threshold = defaults.decompose_threshold;
+    options.threads = defaults.threads;
+    options.alternatives = defaults.alternatives;
+    options.time_limit_ms = 0;
+    options.suboptimality = defaults.suboptimality;
+    options.dominance = defaults.dominance;
+    options.max_memory = defaults.memory_limit;
+    options.open_limit = defaults.open_limit;
+    return options;
+}
+
+void ap_options_init_size(ap_options *options, size_t struct_size)
+{
+    if (options == nullptr || struct_size < ap_options_base_size)
+        return;
+    // A struct of a newer header keeps its size, so that `ap_plan` rejects it
+    auto defaults = defaultOptions();
+    defaults.struct_size = struct_size;
+    std::memcpy(options, &defaults, std::min(struct_size, sizeof(ap_options)));
+}
+
+ap_model *ap_model_load(const char *xml, size_t size)
+{
+    if (xml == nullptr)
+        return nullptr;
+    try
+    {
+        auto model = std::make_unique<ap_model>();
+        IoXml io;
+        bool result;
+        std::tie(model->graph, model->config, result) = io.readBuffer(xml, size);
+        if (!result)
+            return nullptr;
+        return model.release();
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+void ap_model_free(ap_model *model)
+{
+    delete model;
+}
+
+// Exceptions of the planner must not cross the C interface, a failed plan returns NULL
+ap_result *ap_plan(const ap_model *model, const ap_options *options)
+{
+    if (model == nullptr || options == nullptr)
+        return nullptr;
+    if (options->struct_size < ap_options_base_size || options->struct_size > sizeof(ap_options))
+        return nullptr;
+    // Options the caller does not know keep their defaults
+    auto known = defaultOptions();
+    std::memcpy(&known, options, options->struct_size);
+    if (known.solver < AP_SOLVER_ASTAR || known.solver > AP_SOLVER_PARETO)
+        return nullptr;
+    if (!(known.suboptimality >= 1))
+        return nullptr;
+
+    PlannerOptions planner_options;
+    planner_options.solver = SolverType(known.solver);
+    planner_options.prune = known.prune != 0;
+    planner_options.partial_expansion = known.partial_expansion != 0;
+    planner_options.decompose = known.decompose != 0;
+    planner_options.decompose_threshold = known.decompose_threshold;
+    planner_options.threads = known.threads;
+    planner_options.alternatives = std::max<size_t>(1, known.alternatives);
+    planner_options.suboptimality = known.suboptimality;
+    planner_options.dominance = known.dominance != 0;
+    planner_options.memory_limit = known.max_memory;
+    planner_options.open_limit = known.open_limit;
+    planner_options.print = false;
+    if (known.time_limit_ms > 0)
+        planner_options.control.deadline = PlanningControl::Clock::now() +
+            std::chrono::duration_cast<PlanningControl::Clock::duration>(
+                std::chrono::duration<double, std::milli>(known.time_limit_ms));
+
+    try
+    {
+        // The solvers may insert missing entries into the configuration, every call plans on its own copy
+        auto config = model->config;
+        Planner planner(planner_options);
+        planner(model->graph, config);
+
+        auto result = std::make_unique<ap_result>();
+        result->status = planner.status;
+        for (std::size_t i = 0; i < planner.plans.size(); i++)
+        {
+            auto &plan = planner.plans[i];
+            const auto &schedule = planner.schedules[i];
+
+            std::unordered_map<NodeIndex, std::size_t> rounds;
+            for (std::size_t r = 0; r < plan.rounds.size(); r++)
+            {
+                for (const auto &assignment : plan.rounds[r])
+                    rounds[assignment.action_node_id] = r;
+            }
+
+            result->plans.push_back(ap_plan_info{plan.cost, plan.roundCost(config), schedule.makespan,
+                                                 plan.rounds.size(), schedule.actions.size()});
+            result->actions.emplace_back();
+            for (const auto &action : schedule.actions)
+            {
+                result->actions.back().push_back(ap_action{nameOf(action.action).c_str(), nameOf(action.agent).c_str(),
+                                                           rounds[action.action_node_id], action.start, action.end});
+            }
+        }
+        return result.release();
+    }
+    catch (const std::exception &)
+    {
+        return nullptr;
+    }
+}
+
+void ap_result_free(ap_result *result)
+{
+    delete result;
+}
+
+int ap_result_status(const ap_result *result)
+{
+    if (result == nullptr)
+        return AP_ERROR_ARGUMENT;
+    return int(result->status);
+}
+
+size_t ap_result_plan_count(const ap_result *result)
+{
+    return result ? result->plans.size() : 0;
+}
+
+int ap_result_plan(const ap_result *result, size_t plan, ap_plan_info *info)
+{
+    if (result == nullptr || info == nullptr || plan >= result->plans.size())
+        return AP_ERROR_ARGUMENT;
+    *info = result->plans[plan];
+    return AP_OK;
+}
+
+int ap_result_action(const ap_result *result, size_t plan, size_t action, ap_action *out)
+{
+    if (result == nullptr || out == nullptr || plan >= result->actions.size() ||
+        action >= result->actions[plan].size())
+        return AP_ERROR_ARGUMENT;
+    *out = result->actions[plan][action];
+    return AP_OK;
+}
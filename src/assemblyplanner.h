@@ -0,0 +1,114 @@
+#ifndef ASSEMBLYPLANNER_H
+#define ASSEMBLYPLANNER_H
+
+/* C interface of libassemblyplanner.
+ * A model is read once from the XML assembly description and can be planned any number of times,
+ * also from several threads at once. The strings handed out by a result are owned by the library;
+ * they stay valid at least until the result is freed. */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum ap_status
+{
+    AP_OK = 0,
+    AP_ERROR_ARGUMENT = -1
+};
+
+enum ap_solver
+{
+    AP_SOLVER_ASTAR = 0,
+    AP_SOLVER_AOSTAR = 1,
+    AP_SOLVER_PARETO = 2
+};
+
+/* Outcome of the search, see `PlanningStatus` */
+enum ap_planning_status
+{
+    AP_PLANNING_COMPLETE = 0,
+    AP_PLANNING_CANCELLED = 1,
+    AP_PLANNING_DEADLINE = 2
+};
+
+typedef struct ap_model ap_model;
+typedef struct ap_result ap_result;
+
+/* Planner options, initialize with `ap_options_init`.
+ * `struct_size` holds the size of the struct the caller was compiled with. Options are only appended, so the
+ * library takes the defaults for options a caller does not know yet and rejects larger structs. */
+typedef struct ap_options
+{
+    size_t struct_size;
+    int solver;
+    int prune;
+    int partial_expansion;
+    int decompose;
+    size_t decompose_threshold;
+    /* 0 selects the number of hardware threads */
+    size_t threads;
+    size_t alternatives;
+    /* 0 for no limit */
+    double time_limit_ms;
+    /* Accept plans costing up to this factor more than the optimum, 1 searches the optimal plan */
+    double suboptimality;
+    int dominance;
+    /* Bytes of the SMA* search, 0 for no limit */
+    size_t max_memory;
+    /* Hypernodes of the open list kept in memory, 0 keeps all of them */
+    size_t open_limit;
+} ap_options;
+
+typedef struct ap_plan_info
+{
+    /* Sum of the costs of all actions */
+    double cost;
+    /* Objective of the A* search: sum of the mean action cost per round */
+    double round_cost;
+    /* End of the last action of the schedule */
+    double makespan;
+    size_t rounds;
+    size_t actions;
+} ap_plan_info;
+
+/* Action of a plan, in order of the start times of the schedule */
+typedef struct ap_action
+{
+    const char *action;
+    const char *agent;
+    /* Round of the action, 0 is executed first */
+    size_t round;
+    double start;
+    double end;
+} ap_action;
+
+/* Set the defaults of the library for a struct of `struct_size` bytes, see `ap_options_init` */
+void ap_options_init_size(ap_options *options, size_t struct_size);
+
+/* Set the defaults of the library, for the layout of `ap_options` the caller is compiled with */
+static inline void ap_options_init(ap_options *options)
+{
+    ap_options_init_size(options, sizeof(ap_options));
+}
+
+/* Read a model from an XML document in memory, NULL if it cannot be parsed or validated */
+ap_model *ap_model_load(const char *xml, size_t size);
+void ap_model_free(ap_model *model);
+
+/* Plan the model, NULL if the arguments are invalid, `options->struct_size` is not a known layout
+ * or planning failed */
+ap_result *ap_plan(const ap_model *model, const ap_options *options);
+void ap_result_free(ap_result *result);
+
+int ap_result_status(const ap_result *result);
+size_t ap_result_plan_count(const ap_result *result);
+int ap_result_plan(const ap_result *result, size_t plan, ap_plan_info *info);
+int ap_result_action(const ap_result *result, size_t plan, size_t action, ap_action *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
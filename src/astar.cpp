@@ -0,0 +1,350 @@
+#include "astar.hpp"
+
+// Check if given sueprnode is Goal.
+bool AStarSearch::isGoal(Graph<AssemblyData,EdgeData>& graph, const SearchData& current)
+{
+    for (auto &x : current.subassemblies)
+    {
+        if (graph.hasSuccessor(x.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Only subassemblies which are still disassembled count: leaves may carry long names after `applyProgress`,
+// and a goal, whose cheapest action is MAXFLOAT, must have an h score of 0.
+double AStarSearch::calc_hscore(const SearchData& current)
+{
+    std::size_t maximum_length_subassembly = 0;
+    for (auto &x : current.subassemblies)
+    {
+        if (!assembly_.hasSuccessor(x.second))
+            continue;
+        auto length = nameLength(x.second);
+        if (length > maximum_length_subassembly)
+            maximum_length_subassembly = length;
+    }
+    
+    if (maximum_length_subassembly == 0)
+        return 0;
+    double temp = log2f(maximum_length_subassembly) * current.minimum_cost_action;
+    return temp;
+}
+
+std::size_t AStarSearch::nameLength(NodeIndex id)
+{
+    if (id >= name_lengths_.size())
+        name_lengths_.resize(id + 1, 0);
+    if (name_lengths_[id] == 0)
+        name_lengths_[id] = nodeName(assembly_.getNodeData(id)).length();
+    return name_lengths_[id];
+}
+
+double AStarSearch::lowerBound(const SearchData& current)
+{
+    std::size_t rounds = 0;
+    for (auto &x : current.subassemblies)
+        rounds = std::max(rounds, remaining(x.second).rounds);
+    return rounds * minimum_cost_;
+}
+
+double AStarSearch::remainingActions(const SearchData& current)
+{
+    std::size_t actions = 0;
+    for (auto &x : current.subassemblies)
+        actions += remaining(x.second).actions;
+    return actions;
+}
+
+// A subassembly needs the cheapest of its actions, an action needs all subassemblies it splits into.
+// Rounds perform the actions of independent subassemblies in parallel.
+const AStarSearch::Remaining& AStarSearch::remaining(NodeIndex id)
+{
+    if (id >= remaining_.size())
+        remaining_.resize(id + 1);
+    if (remaining_[id].rounds != SIZE_MAX)
+        return remaining_[id];
+
+    Remaining result;
+    auto type = assembly_.getNodeData(id).type;
+    if (type == NodeType::ACTION || type == NodeType::INTERACTION)
+    {
+        result.rounds = 0;
+        for (auto successor : assembly_.successorNodes(id))
+        {
+            auto& next = remaining(successor);
+            result.rounds = std::max(result.rounds, next.rounds);
+            result.actions += next.actions;
+        }
+        result.rounds++;
+        result.actions++;
+    }
+    else if (!assembly_.hasSuccessor(id))
+    {
+        result.rounds = 0;
+    }
+    else
+    {
+        result.actions = SIZE_MAX;
+        for (auto successor : assembly_.successorNodes(id))
+        {
+            auto& next = remaining(successor);
+            result.rounds = std::min(result.rounds, next.rounds);
+            result.actions = std::min(result.actions, next.actions);
+        }
+    }
+    // The recursion may have grown the memo
+    remaining_[id] = result;
+    return remaining_[id];
+}
+
+AStarSearch::AStarSearch(Graph<AssemblyData,EdgeData>& assembly, SearchStatistics* stats,
+                         OpenListType open_list_type, bool partial_expansion)
+  : assembly_(assembly),
+    stats_(stats ? stats : &own_stats_),
+    open_list_type_(open_list_type),
+    partial_expansion_(partial_expansion)
+{}
+
+void AStarSearch::setBound(double bound, double minimum_cost)
+{
+    bound_ = bound;
+    minimum_cost_ = minimum_cost;
+}
+
+void AStarSearch::setControl(const PlanningControl* control)
+{
+    monitor_ = SearchMonitor(control);
+}
+
+void AStarSearch::setFocal(double weight, double minimum_cost)
+{
+    focal_weight_ = weight;
+    minimum_cost_ = minimum_cost;
+}
+
+void AStarSearch::setDominance(const config::Configuration& config)
+{
+    dominance_ = std::make_unique<DominanceIndex>(assembly_, config);
+}
+
+bool AStarSearch::dominated(SearchTree& tree, NodeIndex id)
+{
+    TRACE_SCOPE("DominanceIndex::dominated", "search");
+    const auto& node = tree.node(id);
+    if (dominance_->dominated(tree.state(id), node.g_score))
+    {
+        stats_->nodes_dominated++;
+        tree.releaseState(id);
+        return true;
+    }
+    dominance_->insert(tree.state(id), node.g_score);
+    return false;
+}
+
+void AStarSearch::setCheckpoint(std::chrono::milliseconds interval,
+                                std::function<void(const SearchTree&, const OpenList&, double)> write)
+{
+    checkpoint_ = std::move(write);
+    checkpoint_interval_ = interval;
+    next_checkpoint_ = Clock::now() + interval;
+    checkpoint_countdown_ = checkpoint_stride;
+}
+
+void AStarSearch::checkpoint(const SearchTree& tree, bool force)
+{
+    if (!checkpoint_ || (!force && --checkpoint_countdown_ > 0))
+        return;
+    checkpoint_countdown_ = checkpoint_stride;
+    auto now = Clock::now();
+    if (!force && now < next_checkpoint_)
+        return;
+    {
+        TRACE_SCOPE("AStarSearch::checkpoint", "search");
+        checkpoint_(tree, *open_, bound_);
+    }
+    next_checkpoint_ = Clock::now() + checkpoint_interval_;
+}
+
+// Perform the graph search:
+//   @tree: search tree containing the root, children are appended by the expander.
+//   @root: index of the node at which the search should begin.
+//   @exapnder: exapnder object used for node expansion.
+//   \return: index of the goal node, or `SearchTree::none` if every goal exceeds the bound.
+//
+NodeIndex AStarSearch::search(SearchTree& tree, NodeIndex root, NodeExpander& expander)
+{
+    stats_->nodes_generated++;
+    return search(tree, std::vector<NodeIndex>{root}, expander);
+}
+
+// Restart the graph search from the leaves of a tree, e.g. after its scores were repaired:
+//   @tree:     search tree, children are appended by the expander.
+//   @frontier: unexpanded nodes of the tree, their states must still be available.
+//   @exapnder: exapnder object used for node expansion.
+//   \return:   index of the goal node, or `SearchTree::none` if every goal exceeds the bound.
+//
+NodeIndex AStarSearch::search(SearchTree& tree, const std::vector<NodeIndex>& frontier, NodeExpander& expander)
+{
+    TRACE_SCOPE("AStarSearch::search", "search");
+
+    if (focal_weight_ > 1)
+    {
+        focal_ = std::make_unique<FocalList>(focal_weight_);
+        for (auto id : frontier)
+        {
+            auto& node = tree.node(id);
+            node.h_score = lowerBound(tree.state(id));
+            focal_->push(OpenEntry{node.f_score(), node.g_score, id}, remainingActions(tree.state(id)));
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, focal_->size());
+        return resumeFocal(tree, expander);
+    }
+
+    open_ = makeOpenList(open_list_type_);
+
+    // Closed set is redundant as the search is performed on a acyclic graph where every path is unique.
+    // Nodes can only be reached in one way. Not using the closed-set saves some time used for lookups.
+    for (auto id : frontier)
+    {
+        auto& node = tree.node(id);
+        node.h_score = this->calc_hscore(tree.state(id));
+        open_->push(OpenEntry{node.f_score(), node.g_score, id});
+    }
+    stats_->open_list_peak = std::max(stats_->open_list_peak, open_->size());
+
+    return resume(tree, expander);
+}
+
+// Continue a search from a restored tree:
+//   @tree:    search tree restored from the checkpoint, the states of the open nodes must be available.
+//   @open:    entries of the open list at the time of the checkpoint, with their scores.
+//   \return:  index of the goal node, or `SearchTree::none` if every goal exceeds the bound.
+//
+NodeIndex AStarSearch::restore(SearchTree& tree, const std::vector<OpenEntry>& open, NodeExpander& expander)
+{
+    TRACE_SCOPE("AStarSearch::restore", "search");
+
+    open_ = makeOpenList(open_list_type_);
+    for (const auto& entry : open)
+        open_->push(entry);
+    stats_->open_list_peak = std::max(stats_->open_list_peak, open_->size());
+
+    return resume(tree, expander);
+}
+
+// Pop nodes from the open list of the last search until the next goal is found.
+// Goals are not expanded, so a resumed search never returns the same goal twice.
+//   \return: index of the goal node, or `SearchTree::none` once the open list is exhausted
+//            or the search was stopped by its control.
+//
+NodeIndex AStarSearch::resume(SearchTree& tree, NodeExpander& expander)
+{
+    TRACE_SCOPE("AStarSearch::resume", "search");
+
+    if (focal_)
+        return resumeFocal(tree, expander);
+    while (!open_->empty())
+    {
+        if (monitor_.poll([&] { return SearchProgress{stats_->nodes_expanded, open_->top().f_score, bound_}; }))
+        {
+            checkpoint(tree, true);
+            return SearchTree::none;
+        }
+        checkpoint(tree);
+
+        NodeIndex current = open_->pop().index;
+
+        if (this->isGoal(assembly_, tree.state(current)))
+        {
+            return current;
+        }
+
+        // A partially expanded node is only checked when it is popped for the first time
+        if (dominance_ && std::isinf(expander.nextScore(current)) && dominated(tree, current))
+            continue;
+
+        std::pair<NodeIndex, NodeIndex> children;
+        {
+            TRACE_SCOPE("NodeExpander::expandNode", "search");
+            if (partial_expansion_)
+                children = expander.expandNode(current, open_->empty() ? INFINITY : open_->top().f_score);
+            else
+                children = expander.expandNode(current);
+        }
+
+        double next = partial_expansion_ ? expander.nextScore(current) : INFINITY;
+        if (std::isinf(next))
+        {
+            // Only the parent pointers of expanded nodes are needed from here on
+            tree.releaseState(current);
+        }
+        else
+        {
+            open_->push(OpenEntry{next, tree.node(current).g_score, current});
+        }
+
+        for (NodeIndex child = children.first; child < children.second; child++)
+        {
+            auto& node = tree.node(child);
+            if (node.g_score + lowerBound(tree.state(child)) > bound_)
+            {
+                stats_->nodes_pruned++;
+                tree.releaseState(child);
+                continue;
+            }
+            node.h_score = this->calc_hscore(tree.state(child));
+            open_->push(OpenEntry{node.f_score(), node.g_score, child});
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, open_->size());
+    }
+    return SearchTree::none;
+}
+
+// Focal variant of `resume`. The lowest f score of the open list is a lower bound on the cost of every
+// plan left, so the search also stops once the incumbent is within the bound of it.
+NodeIndex AStarSearch::resumeFocal(SearchTree& tree, NodeExpander& expander)
+{
+    TRACE_SCOPE("AStarSearch::resumeFocal", "search");
+
+    while (!focal_->empty())
+    {
+        if (monitor_.poll([&] { return SearchProgress{stats_->nodes_expanded, focal_->minimumScore(), bound_}; }))
+            return SearchTree::none;
+        if (bound_ <= focal_weight_ * focal_->minimumScore())
+            return SearchTree::none;
+
+        NodeIndex current = focal_->pop().index;
+
+        if (this->isGoal(assembly_, tree.state(current)))
+        {
+            return current;
+        }
+        if (dominance_ && dominated(tree, current))
+            continue;
+
+        std::pair<NodeIndex, NodeIndex> children;
+        {
+            TRACE_SCOPE("NodeExpander::expandNode", "search");
+            children = expander.expandNode(current);
+        }
+        tree.releaseState(current);
+
+        for (NodeIndex child = children.first; child < children.second; child++)
+        {
+            auto& node = tree.node(child);
+            node.h_score = lowerBound(tree.state(child));
+            if (node.f_score() > bound_)
+            {
+                stats_->nodes_pruned++;
+                tree.releaseState(child);
+                continue;
+            }
+            focal_->push(OpenEntry{node.f_score(), node.g_score, child}, remainingActions(tree.state(child)));
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, focal_->size());
+    }
+    return SearchTree::none;
+}
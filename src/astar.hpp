@@ -1,113 +1,105 @@
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <iostream>
-#include <queue>
 
+#include "control.hpp"
+#include "dominance.hpp"
 #include "expander.hpp"
-
-// Comparator used to sort the A* priotity queue
-struct LessThan
-{
-    bool operator()(const Node<SearchData> *lhs, const Node<SearchData> *rhs) const
-    {
-        return (lhs->data.f_score) > (rhs->data.f_score);
-    }
-};
+#include "openlist.hpp"
+#include "trace.hpp"
 
 // Class used to execute the search on a given graph.
 // The expander is used to perform the node-expansion step of the hypergraph.
 struct AStarSearch
 {
-    AStarSearch(Graph<AssemblyData,EdgeData>& assembly);
-
-    Node<SearchData>* search(Graph<SearchData,EdgeData>&, Node<SearchData>*, NodeExpander&);
-    bool isGoal(Graph<AssemblyData,EdgeData>&, Node<SearchData>*);
-    double calc_hscore(Node<SearchData>* current);
-    double calc_fscore(Node<SearchData>* current);
+    AStarSearch(Graph<AssemblyData,EdgeData>& assembly, SearchStatistics* stats = nullptr,
+                OpenListType open_list_type = OpenListType::DARY_HEAP, bool partial_expansion = false);
+
+    NodeIndex search(SearchTree&, NodeIndex, NodeExpander&);
+    // Search from several hypernodes of an existing tree, which together cover every remaining path
+    NodeIndex search(SearchTree&, const std::vector<NodeIndex>&, NodeExpander&);
+    // Continue the last search past the goal it returned, yielding the next goal in order of its f score
+    NodeIndex resume(SearchTree&, NodeExpander&);
+    // Continue a search restored from a checkpoint with the given open list, see `readCheckpoint`
+    NodeIndex restore(SearchTree&, const std::vector<OpenEntry>&, NodeExpander&);
+    bool isGoal(Graph<AssemblyData,EdgeData>&, const SearchData&);
+    double calc_hscore(const SearchData& current);
+
+    // Cost of the incumbent plan, nodes whose g score plus `lowerBound` exceeds it are not added to the
+    // open list. The f score is not admissible and would discard paths to cheaper plans.
+    //   @minimum_cost: cheapest cost of any action for any agent, see `NodeExpander::cheapestAction`
+    void setBound(double bound, double minimum_cost);
+    // Stop the search on cancellation or at the deadline, and report its progress
+    void setControl(const PlanningControl*);
+    // Bounded-suboptimal focal search: expand the node with the fewest remaining actions among the open
+    // nodes whose admissible f score is within `weight` times the lowest one, see `FocalList`.
+    // The returned plan costs at most `weight` times the optimum. Nodes are fully expanded.
+    //   @minimum_cost: cheapest cost of any action for any agent, see `NodeExpander::cheapestAction`
+    void setFocal(double weight, double minimum_cost);
+    // Admissible heuristic of the focal search: rounds still needed by the deepest open subassembly,
+    // each costing at least the cheapest action
+    double lowerBound(const SearchData&);
+    // Secondary heuristic of the focal search: actions still needed by all open subassemblies
+    double remainingActions(const SearchData&);
+    // Discard popped hypernodes dominated by an expanded one before expanding them, see `DominanceIndex`
+    void setDominance(const config::Configuration&);
+    // Pass the tree and the open list to `write` whenever `interval` has passed since the last call,
+    // and when the search is stopped by its control. Called between two expansions.
+    void setCheckpoint(std::chrono::milliseconds interval,
+                       std::function<void(const SearchTree&, const OpenList&, double bound)> write);
 
     Graph<AssemblyData,EdgeData>& assembly_;
-};
-
-// Check if given sueprnode is Goal.
-bool AStarSearch::isGoal(Graph<AssemblyData,EdgeData>& graph, Node<SearchData>* current)
-{
-    for (auto &x : current->data.subassemblies)
-    {
-        if (graph.hasSuccessor(x.second))
-        {
-            return false;
-        }
-    }
-    return true;
-}
-
-double AStarSearch::calc_hscore(Node<SearchData>* current)
-{
-    std::size_t maximum_length_subassembly = 0;
-    for (auto &x : current->data.subassemblies)
+    // Counters updated during the search, points to `own_stats_` if none are provided
+    SearchStatistics own_stats_;
+    SearchStatistics* stats_;
+    // Implementation used for the open list, see `detectOpenListType`
+    OpenListType open_list_type_;
+    // Generate children in order of their g score, only as many as can compete with the open list.
+    // A partially expanded node is reinserted with the g score of its next child as key.
+    bool partial_expansion_;
+    // Upper bound on the cost of the plan
+    double bound_ = INFINITY;
+    // Open list of the last search, kept to resume it
+    std::unique_ptr<OpenList> open_;
+    SearchMonitor monitor_;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    // Fewest rounds and actions still needed to disassemble a node of the assembly graph
+    struct Remaining
     {
-        auto node = assembly_.getNode(x.second);
-        if (node->data.name.length() > maximum_length_subassembly)
-            maximum_length_subassembly = node->data.name.length();
-    }
-    
-    double temp = log2f(maximum_length_subassembly) * current->data.minimum_cost_action;
-    return temp;
-}
-
-double AStarSearch::calc_fscore(Node<SearchData>* current)
-{
-    return current->data.g_score + current->data.h_score;
-}
-
-
-AStarSearch::AStarSearch(Graph<AssemblyData,EdgeData>& assembly)
-  : assembly_(assembly)
-{}
-
-// Perform the graph search:
-//   @graph: pointer to graph on which the search should be performed.
-//   @root: pointer to node at which the search should begin.
-//   @exapnder: exapnder object used for node expansion.
-//
-Node<SearchData>* AStarSearch::search(Graph<SearchData,EdgeData>& graph, 
-                                Node<SearchData>* root, NodeExpander& expander)
-{
-
-    Node<SearchData> *current = nullptr;
-    std::priority_queue<Node<SearchData> *, std::vector<Node<SearchData> *>, LessThan> openSet;
-
-    // Closed set is redundant as the search is performed on a acyclic graph where every path is unique.
-    // Nodes can only be reached in one way. Not using the closed-set saves some time used for lookups.
-    expander.expandNode(root->id);
-    root->data.h_score  = this->calc_hscore(root);
-    root->data.f_score = this->calc_fscore(root);
-
-    openSet.push(root);
-
-    while (!openSet.empty())
-    {
-        current = openSet.top();
-        openSet.pop();
-
-        if (this->isGoal(assembly_, current))
-        {
-            return current;
-        }
-        
-        current->data.marked = true;
-
-        for (auto &edge : graph.getSuccessorEdges(current->id))
-        {
-            Node<SearchData> *child = graph.getNode(edge->getDestination());
-            expander.expandNode(child->id);
-
-            child->data.g_score = current->data.g_score + edge->data.cost;
-            child->data.h_score = this->calc_hscore(child);
-            child->data.f_score = this->calc_fscore(child);
-
-            openSet.push(child);
-        }
-    }
-    return current;
-}
\ No newline at end of file
+        std::size_t rounds = SIZE_MAX;
+        std::size_t actions = 0;
+    };
+
+    NodeIndex resumeFocal(SearchTree&, NodeExpander&);
+    // Whether a popped hypernode is dominated, otherwise it is stored as expanded
+    bool dominated(SearchTree&, NodeIndex);
+    // Resolved once per graph node, the graph only grows by interactions in front of existing nodes
+    const Remaining& remaining(NodeIndex);
+
+    // Write a checkpoint if one is due, the clock is only read every `checkpoint_stride` iterations
+    void checkpoint(const SearchTree&, bool force = false);
+
+    // Length of the name of a subassembly, which grows with the number of parts it contains
+    std::size_t nameLength(NodeIndex);
+    // Name lengths by node, resolved once per node instead of once per evaluation; 0 if not resolved yet
+    std::vector<std::size_t> name_lengths_;
+
+    // Focal search, if the weight is above 1
+    double focal_weight_ = 1;
+    double minimum_cost_ = 0;
+    std::unique_ptr<FocalList> focal_;
+    std::vector<Remaining> remaining_;
+
+    std::unique_ptr<DominanceIndex> dominance_;
+
+    std::function<void(const SearchTree&, const OpenList&, double)> checkpoint_;
+    std::chrono::milliseconds checkpoint_interval_{0};
+    Clock::time_point next_checkpoint_;
+    unsigned checkpoint_countdown_ = 1;
+    static constexpr unsigned checkpoint_stride = 64;
+};
@@ -0,0 +1,399 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "checkpoint.hpp"
+#include "runfile.hpp"
+#include "trace.hpp"
+
+namespace
+{
+
+constexpr std::uint64_t magic = 0x54504b4350534150ULL; // "APSCKPT" followed by a zero byte
+constexpr std::uint64_t version = 1;
+
+// Sync the directory of a file to disk, so that a rename within it survives a crash
+bool syncDirectory(const std::string& path)
+{
+    auto directory = std::filesystem::path(path).parent_path();
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// FNV-1a, the fingerprint has to be stable across processes
+std::uint64_t hashString(const std::string& s)
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : s)
+        h = (h ^ c) * 0x100000001b3ULL;
+    return h;
+}
+
+std::uint64_t hashDouble(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Names are written once to a table at the start of the file and referred to by their position
+class NameTable
+{
+  public:
+    std::uint64_t add(Symbol name)
+    {
+        auto it = index_.emplace(name, names_.size());
+        if (it.second)
+            names_.push_back(name);
+        return it.first->second;
+    }
+    std::uint64_t at(Symbol name) const { return index_.at(name); }
+    const std::vector<Symbol>& names() const { return names_; }
+
+  private:
+    std::vector<Symbol> names_;
+    std::unordered_map<Symbol, std::uint64_t> index_;
+};
+
+void putEdge(RunWriter& out, const NameTable& names, const EdgeData& edge)
+{
+    out.putDouble(edge.cost);
+    out.putVarint(edge.planned_assignments.size());
+    for (const auto& assignment : edge.planned_assignments)
+    {
+        out.putVarint(names.at(assignment.agent));
+        out.putVarint(names.at(assignment.action));
+        out.putVarint(assignment.action_node_id);
+    }
+}
+
+bool getSymbol(RunReader& in, const std::vector<Symbol>& names, Symbol& symbol)
+{
+    std::uint64_t i;
+    if (!in.getVarint(i) || i >= names.size())
+        return false;
+    symbol = names[i];
+    return true;
+}
+
+bool getEdge(RunReader& in, const std::vector<Symbol>& names, EdgeData& edge)
+{
+    std::uint64_t count;
+    if (!in.getDouble(edge.cost) || !in.getVarint(count))
+        return false;
+    edge.planned_assignments.resize(count);
+    for (auto& assignment : edge.planned_assignments)
+    {
+        std::uint64_t node;
+        if (!getSymbol(in, names, assignment.agent) || !getSymbol(in, names, assignment.action) ||
+            !in.getVarint(node))
+            return false;
+        assignment.action_node_id = node;
+    }
+    return true;
+}
+
+std::vector<std::size_t*> counters(SearchStatistics& stats)
+{
+    return {&stats.nodes_generated, &stats.nodes_expanded, &stats.open_list_peak, &stats.duplicate_hits,
+            &stats.nodes_pruned, &stats.assignments_enumerated, &stats.interaction_nodes};
+}
+
+} // namespace
+
+// The items are combined by addition, so the fingerprint does not depend on the order of the hash maps
+CheckpointKey checkpointKey(Graph<AssemblyData,EdgeData>& graph, const config::Configuration& config)
+{
+    CheckpointKey key;
+    key.nodes = graph.nextNodeIndex();
+    key.edges = graph.nextEdgeIndex();
+    for (auto node : graph.nodes())
+        key.fingerprint += mix(node->id ^ (std::uint64_t(node->data.type) << 56) ^ hashString(nodeName(node->data)));
+    for (auto edge : graph.edges())
+        key.fingerprint += mix(mix(edge->getSource()) ^ edge->getDestination());
+    for (const auto& action : config.actions)
+    {
+        for (const auto& cost : action.second.costs)
+            key.fingerprint += mix(hashString(nameOf(action.first)) ^ mix(hashString(nameOf(cost.first)))
+                                   ^ hashDouble(cost.second));
+    }
+    for (const auto& subassembly : config.subassemblies)
+    {
+        for (const auto& reach : subassembly.second.reachability)
+            key.fingerprint += mix(hashString(nameOf(subassembly.first)) ^ mix(hashString(nameOf(reach.first)))
+                                   ^ (reach.second.reachable ? 1 : hashString(nameOf(reach.second.interaction.name))));
+    }
+    return key;
+}
+
+bool writeCheckpoint(const std::string& path, Graph<AssemblyData,EdgeData>& graph, const CheckpointKey& key,
+                     const SearchTree& tree, const OpenList& open, double bound, const SearchStatistics& stats)
+{
+    TRACE_SCOPE("writeCheckpoint", "search");
+
+    NameTable names;
+    for (NodeIndex id = key.nodes; id < graph.nextNodeIndex(); id++)
+    {
+        names.add(graph.getNodeData(id).name);
+        names.add(graph.getNodeData(id).assigned_agent);
+    }
+    for (NodeIndex id = 0; id < tree.size(); id++)
+    {
+        for (const auto& assignment : tree.assignment(id).planned_assignments)
+        {
+            names.add(assignment.agent);
+            names.add(assignment.action);
+        }
+    }
+
+    auto temporary = path + ".tmp";
+    RunWriter out;
+    if (!out.open(temporary))
+        return false;
+    out.putFixed64(magic);
+    out.putVarint(version);
+    out.putVarint(key.nodes);
+    out.putVarint(key.edges);
+    out.putFixed64(key.fingerprint);
+
+    out.putVarint(names.names().size());
+    for (auto name : names.names())
+        out.putString(nameOf(name));
+
+    // Interaction overlay
+    out.putVarint(graph.nextNodeIndex() - key.nodes);
+    for (NodeIndex id = key.nodes; id < graph.nextNodeIndex(); id++)
+    {
+        const auto& data = graph.getNodeData(id);
+        out.putVarint(std::uint64_t(data.type));
+        out.putVarint(names.at(data.name));
+        out.putFixed64(data.key);
+        out.putVarint(names.at(data.assigned_agent));
+        out.putVarint(data.interaction_prev);
+        out.putVarint(data.interaction_or);
+        out.putVarint(data.interaction_next);
+    }
+    out.putVarint(graph.nextEdgeIndex() - key.edges);
+    for (EdgeIndex id = key.edges; id < graph.nextEdgeIndex(); id++)
+    {
+        auto edge = graph.getEdge(id);
+        out.putVarint(edge->getSource());
+        out.putVarint(edge->getDestination());
+        putEdge(out, names, edge->data);
+    }
+
+    // Search tree, parents are stored as the distance to the child
+    out.putVarint(tree.size());
+    std::size_t states = 0;
+    for (NodeIndex id = 0; id < tree.size(); id++)
+    {
+        const auto& node = tree.node(id);
+        out.putVarint(node.parent == SearchTree::none ? 0 : id - node.parent);
+        out.putDouble(node.g_score);
+        out.putDouble(node.h_score);
+        out.putFixed64(node.hash);
+        putEdge(out, names, tree.assignment(id));
+        states += tree.hasState(id);
+    }
+    out.putVarint(states);
+    std::vector<NodeIndex> ids;
+    for (NodeIndex id = 0; id < tree.size(); id++)
+    {
+        if (!tree.hasState(id))
+            continue;
+        const auto& state = tree.state(id);
+        out.putVarint(id);
+        ids.clear();
+        for (const auto& sa : state.subassemblies)
+            ids.push_back(sa.second);
+        std::sort(ids.begin(), ids.end());
+        out.putIds(ids);
+        ids.clear();
+        for (const auto& action : state.actions)
+            ids.push_back(action.second);
+        std::sort(ids.begin(), ids.end());
+        out.putIds(ids);
+        out.putDouble(state.minimum_cost_action);
+    }
+
+    auto entries = open.entries();
+    out.putVarint(entries.size());
+    for (const auto& entry : entries)
+    {
+        out.putDouble(entry.f_score);
+        out.putDouble(entry.g_score);
+        out.putVarint(entry.index);
+    }
+    out.putDouble(bound);
+    auto copy = stats;
+    for (auto counter : counters(copy))
+        out.putVarint(*counter);
+
+    // The data must be on disk before the rename replaces the previous checkpoint, and the rename
+    // before the checkpoint is taken as written
+    if (!out.close(true))
+        return false;
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error && syncDirectory(path);
+}
+
+bool readCheckpoint(const std::string& path, Graph<AssemblyData,EdgeData>& graph, const CheckpointKey& key,
+                    SearchTree& tree, std::vector<OpenEntry>& open, double& bound, SearchStatistics& stats)
+{
+    TRACE_SCOPE("readCheckpoint", "search");
+
+    RunReader in;
+    if (!in.open(path))
+    {
+        std::cerr << "CHECKPOINT ERROR: Could not open " << path << std::endl;
+        return false;
+    }
+    auto corrupt = [&]
+    {
+        std::cerr << "CHECKPOINT ERROR: " << path << " is truncated or corrupt" << std::endl;
+        return false;
+    };
+
+    std::uint64_t file_magic, file_version, nodes, edges, fingerprint;
+    if (!in.getFixed64(file_magic) || file_magic != magic || !in.getVarint(file_version))
+    {
+        std::cerr << "CHECKPOINT ERROR: " << path << " is not a checkpoint" << std::endl;
+        return false;
+    }
+    if (file_version != version)
+    {
+        std::cerr << "CHECKPOINT ERROR: " << path << " has the unsupported version " << file_version << std::endl;
+        return false;
+    }
+    if (!in.getVarint(nodes) || !in.getVarint(edges) || !in.getFixed64(fingerprint))
+        return corrupt();
+    if (nodes != key.nodes || edges != key.edges || fingerprint != key.fingerprint)
+    {
+        std::cerr << "CHECKPOINT ERROR: " << path << " was written for a different assembly or configuration"
+                  << std::endl;
+        return false;
+    }
+
+    std::uint64_t count;
+    if (!in.getVarint(count))
+        return corrupt();
+    std::vector<Symbol> names;
+    std::string name;
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        if (!in.getString(name))
+            return corrupt();
+        names.push_back(intern(name));
+    }
+
+    // The overlay is inserted in its original order, so it receives its original ids
+    if (!in.getVarint(count))
+        return corrupt();
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        AssemblyData data;
+        std::uint64_t type, prev, or_id, next;
+        if (!in.getVarint(type) || !getSymbol(in, names, data.name) || !in.getFixed64(data.key) ||
+            !getSymbol(in, names, data.assigned_agent) || !in.getVarint(prev) || !in.getVarint(or_id) ||
+            !in.getVarint(next))
+            return corrupt();
+        data.type = NodeType(type);
+        data.interaction_prev = prev;
+        data.interaction_or = or_id;
+        data.interaction_next = next;
+        graph.insertNode(data);
+    }
+    if (!in.getVarint(count))
+        return corrupt();
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        std::uint64_t source, destination;
+        EdgeData edge;
+        if (!in.getVarint(source) || !in.getVarint(destination) || !getEdge(in, names, edge) ||
+            source >= graph.nextNodeIndex() || destination >= graph.nextNodeIndex())
+            return corrupt();
+        graph.insertEdge(edge, source, destination);
+    }
+
+    // Nodes are inserted without state first, the open ones receive theirs afterwards
+    if (!in.getVarint(count))
+        return corrupt();
+    for (NodeIndex id = 0; id < count; id++)
+    {
+        std::uint64_t distance, hash;
+        double g, h;
+        EdgeData edge;
+        if (!in.getVarint(distance) || distance > id || !in.getDouble(g) || !in.getDouble(h) ||
+            !in.getFixed64(hash) || !getEdge(in, names, edge))
+            return corrupt();
+        tree.insertNode(distance == 0 ? SearchTree::none : id - distance, g, SearchData(), std::move(edge));
+        tree.eraseState(id);
+        tree.node(id).h_score = h;
+        tree.node(id).hash = hash;
+    }
+    if (!in.getVarint(count))
+        return corrupt();
+    std::vector<NodeIndex> ids;
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        std::uint64_t id;
+        SearchData state;
+        if (!in.getVarint(id) || id >= tree.size() || !in.getIds(ids))
+            return corrupt();
+        for (auto sa : ids)
+            state.subassemblies.set(graph.getNodeData(sa).name, sa);
+        if (!in.getIds(ids))
+            return corrupt();
+        for (auto action : ids)
+            state.actions.set(graph.getNodeData(action).name, action);
+        if (!in.getDouble(state.minimum_cost_action))
+            return corrupt();
+        state.hash = tree.node(id).hash;
+        tree.restoreState(id, std::move(state));
+    }
+
+    if (!in.getVarint(count))
+        return corrupt();
+    open.clear();
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        OpenEntry entry;
+        std::uint64_t index;
+        if (!in.getDouble(entry.f_score) || !in.getDouble(entry.g_score) || !in.getVarint(index) ||
+            index >= tree.size() || !tree.hasState(index))
+            return corrupt();
+        entry.index = index;
+        open.push_back(entry);
+    }
+    if (!in.getDouble(bound))
+        return corrupt();
+    auto restored = stats;
+    for (auto counter : counters(restored))
+    {
+        std::uint64_t value;
+        if (!in.getVarint(value))
+            return corrupt();
+        *counter = value;
+    }
+    stats = restored;
+    return true;
+}
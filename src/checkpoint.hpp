@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "openlist.hpp"
+#include "search_tree.hpp"
+#include "statistics.hpp"
+#include "types.hpp"
+
+// Input of a search a checkpoint belongs to: the ids the assembly graph assigns next, where the
+// interaction overlay added by the expander begins, and a fingerprint of the graph and the configuration.
+struct CheckpointKey
+{
+    NodeIndex nodes = 0;
+    EdgeIndex edges = 0;
+    std::uint64_t fingerprint = 0;
+};
+
+// Key of the search about to start on the given graph and configuration
+CheckpointKey checkpointKey(Graph<AssemblyData,EdgeData>&, const config::Configuration&);
+
+// Snapshot of a running A* search: the interaction nodes added to the graph since the start, the search
+// tree with the states of the open hypernodes, the open list, the bound of the incumbent and the counters.
+// Ids are stored as varints and names as strings. The file is written next to `path`, synced to disk and
+// renamed over it, so an interrupted write or a crash leaves the previous checkpoint intact.
+//   \return: false if the file could not be written
+//
+bool writeCheckpoint(const std::string& path, Graph<AssemblyData,EdgeData>&, const CheckpointKey&,
+                     const SearchTree&, const OpenList&, double bound, const SearchStatistics&);
+
+// Restore a checkpoint written by `writeCheckpoint`. The interactions are appended to the graph, which
+// must be in the state of the key, and the hypernodes to the empty search tree.
+//   @open:  receives the entries of the open list
+//   @bound: receives the bound of the incumbent
+//   @stats: receives the counters
+//   \return: false if the file cannot be read or was written for a different input
+//
+bool readCheckpoint(const std::string& path, Graph<AssemblyData,EdgeData>&, const CheckpointKey&,
+                    SearchTree&, std::vector<OpenEntry>& open, double& bound, SearchStatistics& stats);
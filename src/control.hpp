@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+
+// Outcome of a planning call
+enum class PlanningStatus
+{
+    // The search ran to completion
+    COMPLETE,
+    // The caller cancelled the search, the best plan known at that time is returned
+    CANCELLED,
+    // The deadline passed, the best plan known at that time is returned
+    DEADLINE
+};
+
+// Stops a running search from another thread. Copies share the same state, and once triggered the
+// token stops every planning call it is passed to, so a new token is used for every call.
+class CancellationToken
+{
+  public:
+    CancellationToken();
+
+    void cancel();
+    bool stopped() const;
+    PlanningStatus status() const;
+
+  private:
+    friend class SearchMonitor;
+    // Record that the deadline passed, stopping the other searches sharing the token
+    void expire() const;
+
+    std::shared_ptr<std::atomic<int>> state_;
+};
+
+// Snapshot of a running search passed to the progress callback
+struct SearchProgress
+{
+    std::size_t nodes_expanded = 0;
+    // Lowest f score on the open list
+    double best_f = INFINITY;
+    // Cost of the best plan known so far, INFINITY if there is none
+    double incumbent = INFINITY;
+    double elapsed_ms = 0;
+};
+
+// Limits and progress reporting of a planning call.
+// The callback is invoked from the searching thread, with `--decompose` from several worker threads.
+struct PlanningControl
+{
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken token;
+    Clock::time_point deadline = Clock::time_point::max();
+    std::function<void(const SearchProgress&)> progress;
+    // Minimum time between two calls of the callback
+    std::chrono::milliseconds progress_interval{100};
+};
+
+// Polled once per iteration of a search loop. The token and the clock are only read every `stride`
+// polls and the snapshot is only taken when a report is due, so a poll usually costs a decrement.
+class SearchMonitor
+{
+  public:
+    static constexpr unsigned stride = 16;
+
+    SearchMonitor(const PlanningControl* control = nullptr);
+
+    // True if the search has to stop.
+    //   @snapshot: callable returning the `SearchProgress` of the search, called only for a report
+    template <typename F>
+    bool poll(F snapshot);
+
+  private:
+    template <typename F>
+    bool check(F snapshot);
+
+    const PlanningControl* control_;
+    unsigned countdown_ = 1;
+    PlanningControl::Clock::time_point start_;
+    PlanningControl::Clock::time_point next_report_;
+};
+
+inline CancellationToken::CancellationToken()
+  : state_(std::make_shared<std::atomic<int>>(int(PlanningStatus::COMPLETE)))
+{}
+
+inline void CancellationToken::cancel()
+{
+    int expected = int(PlanningStatus::COMPLETE);
+    state_->compare_exchange_strong(expected, int(PlanningStatus::CANCELLED), std::memory_order_relaxed);
+}
+
+inline void CancellationToken::expire() const
+{
+    int expected = int(PlanningStatus::COMPLETE);
+    state_->compare_exchange_strong(expected, int(PlanningStatus::DEADLINE), std::memory_order_relaxed);
+}
+
+inline bool CancellationToken::stopped() const
+{
+    return state_->load(std::memory_order_relaxed) != int(PlanningStatus::COMPLETE);
+}
+
+inline PlanningStatus CancellationToken::status() const
+{
+    return PlanningStatus(state_->load(std::memory_order_relaxed));
+}
+
+inline SearchMonitor::SearchMonitor(const PlanningControl* control)
+  : control_(control),
+    start_(PlanningControl::Clock::now())
+{
+    if (control_)
+        next_report_ = start_ + control_->progress_interval;
+}
+
+template <typename F>
+inline bool SearchMonitor::poll(F snapshot)
+{
+    if (control_ == nullptr || --countdown_ > 0)
+        return false;
+    countdown_ = stride;
+    return check(snapshot);
+}
+
+template <typename F>
+bool SearchMonitor::check(F snapshot)
+{
+    if (control_->token.stopped())
+        return true;
+
+    auto now = PlanningControl::Clock::now();
+    if (now >= control_->deadline)
+    {
+        control_->token.expire();
+        return true;
+    }
+    if (control_->progress && now >= next_report_)
+    {
+        next_report_ = now + control_->progress_interval;
+        SearchProgress progress = snapshot();
+        progress.elapsed_ms = std::chrono::duration<double, std::milli>(now - start_).count();
+        control_->progress(progress);
+    }
+    return false;
+}
@@ -0,0 +1,256 @@
+#include "decomposer.hpp"
+
+Decomposer::Decomposer(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                       std::size_t threshold, std::size_t threads, SubproblemSolver solver)
+  : graph_(graph),
+    config_(config),
+    threshold_(threshold),
+    threads_(threads),
+    solver_(std::move(solver))
+{}
+
+// Plan the whole assembly.
+//   @stats: receives the summed counters of all subproblem searches
+//   \return: plan rooted at the root of the graph
+//   \throws: the first exception thrown while planning a subproblem, once the running ones finished
+//
+AssemblyPlan Decomposer::solve(SearchStatistics& stats)
+{
+    ScopedPhase phase(&stats, "search");
+    TRACE_SCOPE("Decomposer::solve", "search");
+
+    analyse(graph_.root->id);
+
+    ThreadPool pool(threads_);
+    pool_ = &pool;
+    stats_ = &stats;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& sp : subproblems_)
+    {
+        if (sp.second.pending == 0)
+            schedule(sp.first);
+    }
+    // After a failure the tasks still running are waited for, they refer to the pool and the statistics
+    auto& root = subproblems_.at(graph_.root->id);
+    finished_.wait(lock, [this, &root] { return root.done || (error_ && running_ == 0); });
+
+    pool_ = nullptr;
+    stats_ = nullptr;
+    if (error_)
+    {
+        auto error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+    return root.plan;
+}
+
+void Decomposer::analyse(NodeIndex id)
+{
+    if (subproblems_.count(id))
+        return;
+
+    Subproblem sp;
+    if (!graph_.hasSuccessor(id))
+    {
+        sp.mode = Mode::LEAF;
+    }
+    else if (numberOfActions(id) <= threshold_)
+    {
+        sp.mode = Mode::SEARCH;
+    }
+    else
+    {
+        auto actions = graph_.successorNodes(id);
+        bool independent = std::all_of(actions.begin(), actions.end(),
+                                       [this](NodeIndex a) { return disjointChildren(a); });
+        sp.mode = independent ? Mode::SPLIT : Mode::SEARCH;
+    }
+
+    if (sp.mode == Mode::SPLIT)
+    {
+        std::unordered_set<NodeIndex> children;
+        for (auto action : graph_.successorNodes(id))
+            for (auto child : graph_.successorNodes(action))
+                children.insert(child);
+        sp.dependencies.assign(children.begin(), children.end());
+        sp.pending = sp.dependencies.size();
+    }
+    subproblems_[id] = sp;
+
+    for (auto child : subproblems_.at(id).dependencies)
+    {
+        analyse(child);
+        subproblems_.at(child).parents.push_back(id);
+    }
+}
+
+const std::vector<NodeIndex>& Decomposer::descendants(NodeIndex id)
+{
+    auto it = descendants_.find(id);
+    if (it != descendants_.end())
+        return it->second;
+
+    std::vector<NodeIndex> result{id};
+    for (auto succ : graph_.successorNodes(id))
+    {
+        const auto& below = descendants(succ);
+        std::vector<NodeIndex> merged;
+        std::set_union(result.begin(), result.end(), below.begin(), below.end(),
+                       std::back_inserter(merged));
+        result.swap(merged);
+    }
+    return descendants_[id] = std::move(result);
+}
+
+std::size_t Decomposer::numberOfActions(NodeIndex id)
+{
+    const auto& below = descendants(id);
+    return std::count_if(below.begin(), below.end(), [this](NodeIndex n) {
+        return graph_.getNodeData(n).type == NodeType::ACTION;
+    });
+}
+
+bool Decomposer::disjointChildren(NodeIndex action)
+{
+    auto children = graph_.successorNodes(action);
+    for (std::size_t i = 0; i < children.size(); i++)
+    {
+        for (std::size_t j = i + 1; j < children.size(); j++)
+        {
+            const auto& a = descendants(children[i]);
+            const auto& b = descendants(children[j]);
+            std::vector<NodeIndex> shared;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(shared));
+            if (!shared.empty())
+                return false;
+        }
+    }
+    return true;
+}
+
+// Submit a subproblem whose dependencies are planned. Called with `mutex_` held.
+// The future of the pool is not kept, so exceptions are caught by the task and passed to `solve`;
+// once a subproblem failed, the tasks which did not start yet are skipped.
+void Decomposer::schedule(NodeIndex id)
+{
+    running_++;
+    pool_->submit([this, id]() {
+        Mode mode;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_)
+            {
+                running_--;
+                finished_.notify_all();
+                return;
+            }
+            mode = subproblems_.at(id).mode;
+        }
+
+        SearchStatistics local;
+        AssemblyPlan plan;
+        try
+        {
+            switch (mode)
+            {
+                case Mode::LEAF:
+                    plan = solveLeaf(id);
+                    break;
+                case Mode::SEARCH:
+                    plan = solveSearch(id, local);
+                    break;
+                case Mode::SPLIT:
+                    plan = solveSplit(id);
+                    break;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+            running_--;
+            finished_.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_->nodes_generated += local.nodes_generated;
+        stats_->nodes_expanded += local.nodes_expanded;
+        stats_->open_list_peak = std::max(stats_->open_list_peak, local.open_list_peak);
+        stats_->nodes_pruned += local.nodes_pruned;
+        stats_->assignments_enumerated += local.assignments_enumerated;
+        stats_->interaction_nodes += local.interaction_nodes;
+        stats_->peak_search_bytes += local.peak_search_bytes;
+
+        auto& sp = subproblems_.at(id);
+        sp.plan = std::move(plan);
+        sp.done = true;
+        for (auto parent : sp.parents)
+        {
+            if (--subproblems_.at(parent).pending == 0)
+                schedule(parent);
+        }
+        running_--;
+        if (id == graph_.root->id || error_)
+            finished_.notify_all();
+    });
+}
+
+AssemblyPlan Decomposer::solveLeaf(NodeIndex id)
+{
+    AssemblyPlan plan;
+    plan.graph.root = plan.graph.getNode(plan.graph.insertNode(graph_.getNodeData(id)));
+    return plan;
+}
+
+AssemblyPlan Decomposer::solveSearch(NodeIndex id, SearchStatistics& stats)
+{
+    TRACE_SCOPE("Decomposer::solveSearch", "search");
+
+    // The search inserts interactions, every subproblem works on its own copies
+    auto graph = graph_;
+    auto config = config_;
+    graph.root = graph.getNode(id);
+    return solver_(graph, config, stats);
+}
+
+// Select the cheapest action and agent for a subassembly whose children are planned
+// and combine it with the child plans. Only reads the finished child plans.
+AssemblyPlan Decomposer::solveSplit(NodeIndex id)
+{
+    TRACE_SCOPE("Decomposer::solveSplit", "search");
+
+    // Planning the children is independent of the action and agent chosen for the parent
+    NodeIndex best_action = 0;
+    Symbol best_agent = 0;
+    double best_cost = INFINITY;
+    for (auto action_id : graph_.successorNodes(id))
+    {
+        const auto& action = config_.actions.at(graph_.getNodeData(action_id).name);
+        for (const auto& agent : config_.agents)
+        {
+            double cost = action.costs.at(agent.first);
+            for (auto child : graph_.successorNodes(action_id))
+            {
+                cost += subproblems_.at(child).plan.cost;
+                auto i = cheapestInteraction(config_, graph_.getNodeData(child).name, agent.first);
+                if (i.first)
+                    cost += i.first->costs.at(i.second);
+            }
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_action = action_id;
+                best_agent = agent.first;
+            }
+        }
+    }
+
+    std::vector<const AssemblyPlan*> child_plans;
+    for (auto child : graph_.successorNodes(best_action))
+        child_plans.push_back(&subproblems_.at(child).plan);
+    return composePlan(graph_, config_, id, best_action, best_agent, child_plans);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.hpp"
+#include "plan.hpp"
+#include "statistics.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
+#include "types.hpp"
+
+// Solver used for subassemblies which are not decomposed any further.
+// Receives a private copy of the graph (rooted at the subassembly) and of the configuration.
+using SubproblemSolver = std::function<AssemblyPlan(Graph<AssemblyData,EdgeData>&,
+                                                    config::Configuration&, SearchStatistics&)>;
+
+// Divide-and-conquer planning.
+// An action splits a subassembly into children. If the AND/OR subtrees of the children share no
+// nodes, the children can be planned independently: their plans only compete for agents.
+// The `Decomposer` plans such children separately on a thread pool, selects the cheapest action
+// and agent for the parent, and merges the child plans into common rounds, delaying assignments
+// whose agent is already busy in a round. Subassemblies below the size threshold, and those with
+// actions whose children share subtrees, are handed to the `SubproblemSolver` as a whole.
+//
+// The decomposition minimizes the total action cost of the plan. Parallelism between independent
+// subassemblies is recovered by the merge, but is not optimized across them.
+class Decomposer
+{
+  public:
+    Decomposer(Graph<AssemblyData,EdgeData>&, config::Configuration&,
+               std::size_t threshold, std::size_t threads, SubproblemSolver);
+
+    AssemblyPlan solve(SearchStatistics&);
+
+  private:
+    enum class Mode
+    {
+        LEAF,
+        SEARCH,
+        SPLIT
+    };
+
+    struct Subproblem
+    {
+        Mode mode;
+        // Children of all actions of a SPLIT subassembly
+        std::vector<NodeIndex> dependencies;
+        // Subassemblies depending on this one
+        std::vector<NodeIndex> parents;
+        // Dependencies which are not planned yet
+        std::size_t pending = 0;
+        bool done = false;
+        AssemblyPlan plan;
+    };
+
+    // Decide how a subassembly is solved, recursively for all dependencies
+    void analyse(NodeIndex);
+    // Sorted indexes of all nodes reachable from the given node, including itself
+    const std::vector<NodeIndex>& descendants(NodeIndex);
+    std::size_t numberOfActions(NodeIndex);
+    bool disjointChildren(NodeIndex action);
+
+    AssemblyPlan solveLeaf(NodeIndex);
+    AssemblyPlan solveSearch(NodeIndex, SearchStatistics&);
+    AssemblyPlan solveSplit(NodeIndex);
+    void schedule(NodeIndex);
+
+    Graph<AssemblyData,EdgeData>& graph_;
+    config::Configuration& config_;
+    std::size_t threshold_;
+    std::size_t threads_;
+    SubproblemSolver solver_;
+
+    std::unordered_map<NodeIndex, std::vector<NodeIndex>> descendants_;
+    std::unordered_map<NodeIndex, Subproblem> subproblems_;
+
+    // Scheduling state shared with the workers
+    ThreadPool* pool_ = nullptr;
+    SearchStatistics* stats_ = nullptr;
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    // Tasks submitted and not finished yet, and the first exception thrown by one of them
+    std::size_t running_ = 0;
+    std::exception_ptr error_;
+};
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <climits>
+
+#include "dominance.hpp"
+
+DominanceIndex::DominanceIndex(Graph<AssemblyData,EdgeData>& assembly, const config::Configuration& config)
+  : assembly_(assembly),
+    config_(config),
+    trie_(1)
+{
+    if (config_.agents.size() <= 1)
+        return;
+
+    // Missing costs count as 0, interactions are not part of the actions unless they were assigned before
+    double lowest = INFINITY;
+    double highest = 0;
+    auto add = [&](Symbol name)
+    {
+        auto action = config_.actions.find(name);
+        for (const auto& agent : config_.agents)
+        {
+            double cost = 0;
+            if (action != config_.actions.end())
+            {
+                auto it = action->second.costs.find(agent.first);
+                cost = it == action->second.costs.end() ? 0 : it->second;
+            }
+            lowest = std::min(lowest, cost);
+            if (cost < INT_MAX)
+                highest = std::max(highest, cost);
+        }
+    };
+    for (const auto& action : config_.actions)
+        add(action.first);
+    for (const auto& subassembly : config_.subassemblies)
+    {
+        for (const auto& agent : config_.agents)
+        {
+            auto reach = subassembly.second.reachability.find(agent.first);
+            if (reach == subassembly.second.reachability.end())
+                add(0);
+            else if (!reach->second.reachable)
+                add(reach->second.interaction.name);
+        }
+    }
+    if (lowest < highest)
+        weight_ = (highest - lowest) / 2;
+}
+
+bool DominanceIndex::dominated(const SearchData& state, double g_score)
+{
+    double limit = g_score - elements(state, scratch_);
+    return contains(0, scratch_, 0, limit);
+}
+
+void DominanceIndex::insert(const SearchData& state, double g_score)
+{
+    double key = g_score - elements(state, scratch_);
+    std::uint32_t current = 0;
+    trie_[current].below = std::min(trie_[current].below, key);
+    for (auto element : scratch_)
+    {
+        auto& children = trie_[current].children;
+        auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(element, std::uint32_t(0)));
+        if (it == children.end() || it->first != element)
+        {
+            std::uint32_t next = trie_.size();
+            children.insert(it, std::make_pair(element, next));
+            // Growing the trie moves the nodes, `children` is not used afterwards
+            trie_.emplace_back();
+            current = next;
+        }
+        else
+        {
+            current = it->second;
+        }
+        trie_[current].below = std::min(trie_[current].below, key);
+    }
+    trie_[current].key = std::min(trie_[current].key, key);
+    size_++;
+}
+
+std::size_t DominanceIndex::size() const
+{
+    return size_;
+}
+
+double DominanceIndex::elements(const SearchData& state, std::vector<std::uint32_t>& out)
+{
+    out.clear();
+    double weight = 0;
+    for (const auto& x : state.subassemblies)
+    {
+        auto id = element(x.second);
+        if (id == leaf)
+            continue;
+        out.push_back(id);
+        weight += weights_[id];
+    }
+    std::sort(out.begin(), out.end());
+    return weight;
+}
+
+std::uint32_t DominanceIndex::element(NodeIndex id)
+{
+    if (id >= elements_.size())
+        elements_.resize(id + 1, unresolved);
+    if (elements_[id] != unresolved)
+        return elements_[id];
+
+    const auto& data = assembly_.getNodeData(id);
+    std::pair<NodeIndex, Symbol> key;
+    std::size_t actions;
+    if (data.type == NodeType::INTERASSEMBLY)
+    {
+        // The interaction hands over the subassembly to the agent of the next round
+        const auto& interaction = assembly_.getNodeData(assembly_.successorNodes(id).front());
+        key = std::make_pair(NodeIndex(interaction.interaction_next), interaction.name);
+        actions = 1 + mostActions(interaction.interaction_next);
+    }
+    else if (data.type == NodeType::SUBASSEMBLY && assembly_.hasSuccessor(id))
+    {
+        key = std::make_pair(id, Symbol(0));
+        actions = mostActions(id);
+    }
+    else
+    {
+        return elements_[id] = leaf;
+    }
+
+    auto it = ids_.find(key);
+    if (it == ids_.end())
+    {
+        it = ids_.emplace(key, std::uint32_t(weights_.size())).first;
+        weights_.push_back(actions * weight_);
+    }
+    return elements_[id] = it->second;
+}
+
+// Every action may hand each of its children over through an interaction
+std::size_t DominanceIndex::mostActions(NodeIndex id)
+{
+    if (id >= most_actions_.size())
+        most_actions_.resize(id + 1, SIZE_MAX);
+    if (most_actions_[id] != SIZE_MAX)
+        return most_actions_[id];
+
+    std::size_t most = 0;
+    for (auto action : assembly_.successorNodes(id))
+    {
+        std::size_t actions = 1;
+        for (auto child : assembly_.successorNodes(action))
+        {
+            actions += mostActions(child);
+            auto subassembly = config_.subassemblies.find(assembly_.getNodeData(child).name);
+            bool interaction = subassembly == config_.subassemblies.end();
+            for (auto agent = config_.agents.begin(); !interaction && agent != config_.agents.end(); ++agent)
+            {
+                auto reach = subassembly->second.reachability.find(agent->first);
+                interaction = reach == subassembly->second.reachability.end() || !reach->second.reachable;
+            }
+            actions += interaction;
+        }
+        most = std::max(most, actions);
+    }
+    // The recursion may have grown the memo
+    most_actions_[id] = most;
+    return most;
+}
+
+bool DominanceIndex::contains(std::uint32_t trie_node, const std::vector<std::uint32_t>& elements,
+                              std::size_t from, double limit) const
+{
+    const auto& node = trie_[trie_node];
+    if (node.below > limit)
+        return false;
+    if (node.key <= limit)
+        return true;
+    std::size_t i = from;
+    for (const auto& child : node.children)
+    {
+        while (i < elements.size() && elements[i] < child.first)
+            i++;
+        if (i == elements.size())
+            break;
+        if (elements[i] == child.first && contains(child.second, elements, i + 1, limit))
+            return true;
+    }
+    return false;
+}
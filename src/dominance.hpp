@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+#include "types.hpp"
+
+// Dominance between hypernodes of the A* search. A hypernode A dominates B if every subassembly A still
+// has to disassemble is open in B as well and A is not more expensive, so every plan continuing B can be
+// replayed from A by leaving out the actions on the other subassemblies of B.
+// A round costs the mean of its actions, so leaving out actions can make a round more expensive: each
+// action left out raises it by at most half the spread between the costliest and the cheapest action.
+// B is therefore only dominated if
+//     g(A) + sum of w(s) over the subassemblies s of B not in A  <=  g(B)
+// where w(s) is the most actions (interactions included) s can still take times half the spread; with a
+// single agent every round holds one action and w is 0. Costs of infeasible assignments do not count
+// towards the spread, as no plan of finite cost takes them.
+// The condition splits into a key k(A) = g(A) - sum of w over A and a limit g(B) - sum of w over B,
+// so the index only answers whether any stored subset of B has a key within its limit.
+//
+// Subassemblies are stored as sorted element ids in a subset trie, every node holding the lowest key
+// below it so that branches which cannot dominate are skipped. Interassemblies created by different
+// expansions for the same subassembly and interaction are the same element.
+class DominanceIndex
+{
+  public:
+    DominanceIndex(Graph<AssemblyData,EdgeData>&, const config::Configuration&);
+
+    // Whether a stored hypernode dominates the given state
+    bool dominated(const SearchData&, double g_score);
+    // Store an expanded hypernode
+    void insert(const SearchData&, double g_score);
+
+    std::size_t size() const;
+
+  private:
+    struct TrieNode
+    {
+        // Sorted by element
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> children;
+        // Lowest key of a hypernode ending here, and of any hypernode below
+        double key = INFINITY;
+        double below = INFINITY;
+    };
+
+    // Sorted elements of the open subassemblies of a state, and the sum of their weights
+    double elements(const SearchData&, std::vector<std::uint32_t>&);
+    // Element of a graph node, `leaf` if there is nothing left to disassemble
+    std::uint32_t element(NodeIndex);
+    // Most actions still taken by a subassembly of the original graph
+    std::size_t mostActions(NodeIndex);
+    bool contains(std::uint32_t trie_node, const std::vector<std::uint32_t>&, std::size_t from, double limit) const;
+
+    static constexpr std::uint32_t unresolved = UINT32_MAX;
+    static constexpr std::uint32_t leaf = UINT32_MAX - 1;
+
+    Graph<AssemblyData,EdgeData>& assembly_;
+    const config::Configuration& config_;
+    // Half the spread of the action costs, 0 with a single agent
+    double weight_ = 0;
+
+    std::vector<TrieNode> trie_;
+    std::size_t size_ = 0;
+    // Elements by subassembly and interaction (0 for a plain subassembly), and their weights
+    std::map<std::pair<NodeIndex, Symbol>, std::uint32_t> ids_;
+    std::vector<double> weights_;
+    // Resolved once per graph node, the graph only grows by interactions in front of existing nodes
+    std::vector<std::uint32_t> elements_;
+    std::vector<std::size_t> most_actions_;
+    std::vector<std::uint32_t> scratch_;
+};
@@ -5,6 +5,7 @@
 #include "node.hpp"
 #include "types.hpp"
 #include "graph.hpp"
+#include "trace.hpp"
 
 // Implements the writing of .dot files for graphs
 struct DotWriter
@@ -12,6 +13,8 @@ struct DotWriter
     template <typename N>
     static void write(Graph<N,EdgeData>& graph, std::string path)
     {
+        TRACE_SCOPE("DotWriter::write", "io");
+
         std::fstream fs;
         fs.open(path, std::fstream::out);
         fs << "digraph G {" << std::endl;
@@ -57,21 +60,21 @@ struct DotWriter
         switch (node->data.type)
         {
             case NodeType::SUBASSEMBLY:
-                fs << " [label=\""<< node->data.name
+                fs << " [label=\""<< nodeName(node->data)
                    << "\" shape=\"rectangle\"";
                 break;
             case NodeType::INTERASSEMBLY:
-                fs << " [label=\""<< node->data.name 
+                fs << " [label=\""<< nodeName(node->data)
                    << "\" shape=\"rectangle\" color=\"blue\"";
                 break;
             case NodeType::INTERACTION:
-                fs << " [label=\""<< node->data.name 
-                   << " - " << node->data.assigned_agent 
+                fs << " [label=\""<< nodeName(node->data)
+                   << " - " << nameOf(node->data.assigned_agent)
                    << "\" color=\"blue\"";
                 break;
             case NodeType::ACTION:
-                fs << " [label=\""<< node->data.name 
-                   << " - " << node->data.assigned_agent << "\"";
+                fs << " [label=\""<< nodeName(node->data)
+                   << " - " << nameOf(node->data.assigned_agent) << "\"";
         }
         fs << "];" << std::endl;
     }
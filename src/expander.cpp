@@ -0,0 +1,265 @@
+#include "expander.hpp"
+
+NodeExpander::NodeExpander(Graph<AssemblyData,EdgeData>& assembly_graph, 
+        SearchTree& search_tree, config::Configuration& conf,
+        SearchStatistics* stats)
+  : assembly_graph_(assembly_graph),
+    search_tree_(search_tree),
+    config(conf),
+    assignment_generator_(config),
+    stats_(stats ? stats : &own_stats_)
+{}
+
+// Node expansion: the A* search algorithm calls `expandNode` when a new hypernode is processed.
+// The nodes produeced by this function, are introduced into the search tree as result.
+std::pair<NodeIndex, NodeIndex> NodeExpander::expandNode(NodeIndex node_id)
+{
+    // Copy the parent data, the state storage may be reallocated while children are inserted
+    const SearchData node_data = search_tree_.state(node_id);
+    const double node_g_score = search_tree_.node(node_id).g_score;
+    const NodeIndex first_child = search_tree_.size();
+
+    auto nodes = openSubassemblies(node_data);
+
+    // Obtain all possible combinations of agents-action assignments for the current step
+    // The mean cost of the assignment is added to the g score of the child
+    const auto assignments_ = assignment_generator_.generateAgentActionAssignments(
+        assembly_graph_, nodes, bound_ - node_g_score);
+    stats_->nodes_expanded++;
+    stats_->assignments_enumerated += assignments_.size();
+    stats_->nodes_pruned += assignment_generator_.discarded();
+    
+    // Iterate through all possible assignments of agents to available actions
+    for (const auto& cur_assignments : assignments_)
+    {
+        insertChild(node_id, node_data, node_g_score, cur_assignments);
+    }
+
+    return std::make_pair(first_child, NodeIndex(search_tree_.size()));
+}
+
+std::pair<NodeIndex, NodeIndex> NodeExpander::expandNode(NodeIndex node_id, double limit)
+{
+    const SearchData node_data = search_tree_.state(node_id);
+    const double node_g_score = search_tree_.node(node_id).g_score;
+    const NodeIndex first_child = search_tree_.size();
+
+    auto it = pending_.find(node_id);
+    if (it == pending_.end())
+    {
+        auto nodes = openSubassemblies(node_data);
+        it = pending_.emplace(node_id, RankedCombinator(assembly_graph_, config, nodes)).first;
+    }
+    stats_->nodes_expanded++;
+
+    // Assignments come in order of their mean cost, the first one over the limit ends the batch
+    auto& ranked = it->second;
+    const double cap = std::min(limit, bound_);
+    while (!std::isinf(ranked.peek()) && node_g_score + ranked.peek() <= cap)
+    {
+        insertChild(node_id, node_data, node_g_score, ranked.next());
+        stats_->assignments_enumerated++;
+    }
+
+    if (std::isinf(ranked.peek()) || node_g_score + ranked.peek() > bound_)
+        pending_.erase(it);
+
+    return std::make_pair(first_child, NodeIndex(search_tree_.size()));
+}
+
+NodeIndex NodeExpander::expandAssignment(NodeIndex node_id, const std::vector<AgentActionAssignment>& assignment)
+{
+    const SearchData node_data = search_tree_.state(node_id);
+    insertChild(node_id, node_data, search_tree_.node(node_id).g_score, assignment);
+    return search_tree_.size() - 1;
+}
+
+double NodeExpander::nextScore(NodeIndex node_id) const
+{
+    auto it = pending_.find(node_id);
+    if (it == pending_.end())
+        return INFINITY;
+    return search_tree_.node(node_id).g_score + it->second.peek();
+}
+
+std::vector<NodeIndex> NodeExpander::openSubassemblies(const SearchData& data)
+{
+    std::vector<NodeIndex> nodes;
+    for (const auto& sa : data.subassemblies)
+    {
+        if (assembly_graph_.hasSuccessor(sa.second))
+            nodes.push_back(NodeIndex(sa.second));
+    }
+    return nodes;
+}
+
+void NodeExpander::insertChild(NodeIndex node_id, const SearchData& node_data, double node_g_score,
+                               const std::vector<AgentActionAssignment>& cur_assignments)
+{
+    // Create the data for the created supernode.
+    // The copy shares the maps of the parent until the assignment writes to them
+    SearchData x = node_data;
+    // Temporary edge data
+    EdgeData y;
+    y.cost = 0;
+
+    // Needed to calculate the average cost for the connecting edge.
+    int iters = 0;
+
+    // Iterate through agent-action pairs for the current assignemnt
+    for (const auto& assignment : cur_assignments)
+    {
+        iters++;
+
+        const auto& agent = assignment.agent;
+        const auto& action = assignment.action;
+        const auto& action_node_id = assignment.action_node_id;
+
+        // Update the data for the newly-created supernode.
+        auto action_source_id = assembly_graph_.predecessorNodes(action_node_id).front();
+        auto action_source = assembly_graph_.getNodeData(action_source_id).name;
+        eraseEntry(x, x.subassemblies, action_source);
+        eraseEntry(x, x.actions, action);
+
+        // For the currently applied assignement, update the subassemblies of the new supernode.
+        for (auto& successor_id : assembly_graph_.successorNodes(action_node_id))
+        {
+            auto successor = assembly_graph_.getNodeData(successor_id);
+            NodeIndex ors_prime = successor_id;
+
+            bool part_reachable = config.subassemblies[successor.name].reachability[agent].reachable;
+
+            // If part not reachable add interaction
+            if (!part_reachable)
+            {
+                auto interaction = config.subassemblies[successor.name].reachability[agent].interaction.name;
+                ors_prime = createInteraction(action_node_id, successor_id, successor, interaction);
+            }
+
+            setEntry(x, x.subassemblies, successor.name, ors_prime);
+
+            for (const auto& next_action_id : assembly_graph_.successorNodes(ors_prime))
+            {
+                setEntry(x, x.actions, assembly_graph_.getNodeData(next_action_id).name, next_action_id);
+            }
+        }
+
+        // Update edge data.
+        y.cost += config.actions[action].costs[agent];
+        y.planned_assignments.push_back(assignment);
+    }
+
+    // Create the average of the edge.cost over the number of nodes it connects.
+    // Every node in the search graph is a hyper-node produced by many nodes from the assembly.
+    // This makes taking the average over the number of represented nodes necessary.
+    y.cost = y.cost / iters;
+
+    // Set the minimum agent-action cost of the new supernode.
+    // Needed for the heuristic used by the A* algorithm.
+    x.minimum_cost_action = minimumActionCost(x);
+
+    // Insert the newly created sueprnode into the search tree.
+    double g_score = node_g_score + y.cost;
+    search_tree_.insertNode(node_id, g_score, std::move(x), std::move(y));
+    stats_->nodes_generated++;
+}
+
+// The hash of a child is updated with every entry removed from or written to its state,
+// instead of being recomputed from all open subassemblies and actions
+void NodeExpander::eraseEntry(SearchData& data, PersistentMap& entries, Symbol name)
+{
+    if (auto previous = entries.erase(name))
+        data.hash ^= assembly_graph_.getNodeData(*previous).key;
+}
+
+void NodeExpander::setEntry(SearchData& data, PersistentMap& entries, Symbol name, NodeIndex id)
+{
+    if (auto previous = entries.set(name, id))
+        data.hash ^= assembly_graph_.getNodeData(*previous).key;
+    data.hash ^= assembly_graph_.getNodeData(id).key;
+}
+
+void NodeExpander::setBound(double bound)
+{
+    bound_ = bound;
+}
+
+void NodeExpander::reuseInteractions(bool reuse)
+{
+    reuse_interactions_ = reuse;
+}
+
+// The minimum is taken over the same agent-action pairs the `Combinator` would assign
+// when expanding the state, without enumerating the assignments.
+double NodeExpander::minimumActionCost(const SearchData& data)
+{
+    double minimum = MAXFLOAT;
+    for (const auto& sa : data.subassemblies)
+    {
+        for (const auto& action_id : assembly_graph_.successorNodes(sa.second))
+        {
+            auto& costs = config.actions[assembly_graph_.getNodeData(action_id).name].costs;
+            for (const auto& agent : config.agents)
+            {
+                minimum = std::min(minimum, costs[agent.first]);
+            }
+        }
+    }
+    return minimum;
+}
+
+// Costs missing from the configuration are taken as 0, as in `insertChild`
+double NodeExpander::cheapestAction() const
+{
+    double minimum = MAXFLOAT;
+    for (const auto& action : config.actions)
+    {
+        for (const auto& agent : config.agents)
+        {
+            auto cost = action.second.costs.find(agent.first);
+            minimum = std::min(minimum, cost == action.second.costs.end() ? 0.0 : cost->second);
+        }
+    }
+    return minimum;
+}
+
+// Interactions are created for assignemnts where a given agent cannot reach a part (subassembly).
+NodeIndex NodeExpander::createInteraction(NodeIndex src_id, NodeIndex dest_id, 
+                    AssemblyData& dest_data, Symbol iname)
+{
+    if (reuse_interactions_)
+    {
+        auto known = interactions_.find(std::make_tuple(src_id, dest_id, iname));
+        if (known != interactions_.end())
+            return known->second;
+    }
+
+    // Create interaction subassembly cotaining the same data as original one.
+    // It keeps the name of the subassembly, the writers mark it with a prime.
+    AssemblyData tdata = dest_data;
+    tdata.type = NodeType::INTERASSEMBLY;
+    auto or_prime_id = assembly_graph_.insertNode(tdata);
+    assembly_graph_.getNodeData(or_prime_id).key = zobristKey(or_prime_id);
+    // Create node for interaction
+    AssemblyData idata;
+    idata.name = iname;
+    idata.type = NodeType::INTERACTION;
+    // Set pointer of action that triggered interaction 
+    // Needed for backtracking the optimal solution at the planner level, 
+    // since interaction are not inserted directly into the graph, 
+    // but are an overlay layer on top of it, with a forward-path only
+    idata.interaction_prev = src_id;
+    idata.interaction_or = or_prime_id;
+    idata.interaction_next = dest_id;
+
+    auto interaction_id = assembly_graph_.insertNode(idata);
+    assembly_graph_.getNodeData(interaction_id).key = zobristKey(interaction_id);
+    // Insert interaction between corresponding nodes
+    assembly_graph_.insertEdge(EdgeData(), or_prime_id, interaction_id);
+    assembly_graph_.insertEdge(EdgeData(), interaction_id, dest_id);
+    stats_->interaction_nodes++;
+    if (reuse_interactions_)
+        interactions_.emplace(std::make_tuple(src_id, dest_id, iname), or_prime_id);
+    // Return the interaction subassembly to insert into the current supernode.
+    return or_prime_id;
+}
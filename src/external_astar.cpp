@@ -0,0 +1,435 @@
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <random>
+
+#include "external_astar.hpp"
+
+ExternalAStarSearch::ExternalAStarSearch(Graph<AssemblyData,EdgeData>& assembly, SearchStatistics* stats,
+                                         std::size_t open_limit, std::string directory)
+  : assembly_(assembly),
+    stats_(stats ? stats : &own_stats_),
+    astar_(assembly),
+    open_limit_(std::max<std::size_t>(open_limit, 2))
+{
+    // Searches of the decomposition run in parallel, every search writes to a directory of its own
+    static std::atomic<unsigned> searches{0};
+    std::filesystem::path base = directory;
+    if (directory.empty())
+    {
+        std::error_code error;
+        base = std::filesystem::temp_directory_path(error);
+    }
+    directory_ = (base / ("planner-" + std::to_string(std::random_device()()) + "-" +
+                          std::to_string(searches++))).string();
+}
+
+ExternalAStarSearch::~ExternalAStarSearch()
+{
+    open_runs_.clear();
+    closed_runs_.clear();
+    if (files_ > 0)
+    {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+}
+
+void ExternalAStarSearch::setBound(double bound, double minimum_cost)
+{
+    bound_ = bound;
+    astar_.setBound(bound, minimum_cost);
+}
+
+void ExternalAStarSearch::setControl(const PlanningControl* control)
+{
+    monitor_ = SearchMonitor(control);
+}
+
+// Perform the graph search:
+//   @tree:     search tree containing the root, children are appended by the expander.
+//   @root:     index of the node at which the search should begin.
+//   @expander: expander object used for node expansion, its children are fully generated.
+//
+NodeIndex ExternalAStarSearch::search(SearchTree& tree, NodeIndex root, NodeExpander& expander)
+{
+    TRACE_SCOPE("ExternalAStarSearch::search", "search");
+
+    auto& root_node = tree.node(root);
+    root_node.h_score = astar_.calc_hscore(tree.state(root));
+    frontier_.push(OpenEntry{root_node.f_score(), root_node.g_score, root});
+    stats_->nodes_generated++;
+
+    while (true)
+    {
+        auto best_run = std::min_element(open_runs_.begin(), open_runs_.end(), [&](const auto& a, const auto& b)
+                                         { return openBefore(tree, a->head.node, b->head.node); });
+        if (monitor_.poll([&]
+            {
+                double best = frontier_.empty() ? INFINITY : frontier_.top().f_score;
+                if (best_run != open_runs_.end())
+                    best = std::min(best, tree.node((*best_run)->head.node).f_score());
+                return SearchProgress{stats_->nodes_expanded, best, bound_};
+            }))
+            return SearchTree::none;
+
+        if (best_run != open_runs_.end() &&
+            (frontier_.empty() || openBefore(tree, (*best_run)->head.node, frontier_.top().index)))
+        {
+            if (!load(tree, expander))
+                return SearchTree::none;
+            continue;
+        }
+        if (frontier_.empty())
+            return SearchTree::none;
+
+        NodeIndex current = frontier_.pop().index;
+        if (astar_.isGoal(assembly_, tree.state(current)))
+            return current;
+
+        std::pair<NodeIndex, NodeIndex> children;
+        {
+            TRACE_SCOPE("NodeExpander::expandNode", "search");
+            children = expander.expandNode(current);
+        }
+        close(tree, current);
+        tree.releaseState(current);
+
+        for (NodeIndex child = children.first; child < children.second; child++)
+        {
+            auto& node = tree.node(child);
+            if (node.g_score + astar_.lowerBound(tree.state(child)) > bound_)
+            {
+                stats_->nodes_pruned++;
+                tree.releaseState(child);
+                continue;
+            }
+            node.h_score = astar_.calc_hscore(tree.state(child));
+            frontier_.push(OpenEntry{node.f_score(), node.g_score, child});
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, frontier_.size());
+
+        if (frontier_.size() > open_limit_)
+            spill(tree);
+    }
+}
+
+// The frontier is drained in order, so the spilled entries are already sorted
+void ExternalAStarSearch::spill(SearchTree& tree)
+{
+    TRACE_SCOPE("ExternalAStarSearch::spill", "search");
+
+    std::vector<OpenEntry> keep;
+    while (keep.size() < open_limit_ / 2)
+        keep.push_back(frontier_.pop());
+    std::vector<OpenEntry> entries;
+    std::vector<StateRecord> records;
+    while (!frontier_.empty())
+    {
+        entries.push_back(frontier_.pop());
+        records.push_back(record(entries.back().index, tree.state(entries.back().index)));
+    }
+
+    auto run = writeRun(records);
+    if (run == nullptr)
+    {
+        std::cerr << "SEARCH ERROR: Could not write a run file to " << directory_
+                  << ", the open list is kept in memory" << std::endl;
+        open_limit_ = SIZE_MAX;
+        keep.insert(keep.end(), entries.begin(), entries.end());
+    }
+    else
+    {
+        for (const auto& entry : entries)
+            tree.eraseState(entry.index);
+        stats_->nodes_spilled += entries.size();
+        open_runs_.push_back(std::move(run));
+    }
+    for (const auto& entry : keep)
+        frontier_.push(entry);
+
+    if (open_runs_.size() > max_runs && !compact(tree, open_runs_, false))
+    {
+        std::cerr << "SEARCH ERROR: Could not merge the run files in " << directory_ << std::endl;
+        open_limit_ = SIZE_MAX;
+    }
+}
+
+bool ExternalAStarSearch::load(SearchTree& tree, NodeExpander& expander)
+{
+    TRACE_SCOPE("ExternalAStarSearch::load", "search");
+
+    // Fill half of the free space, but read at least one complete f layer
+    std::size_t room = std::max<std::size_t>(1, (open_limit_ - std::min(open_limit_, frontier_.size())) / 2);
+    std::vector<StateRecord> batch;
+    double layer = NAN;
+    while (!open_runs_.empty())
+    {
+        auto best = std::min_element(open_runs_.begin(), open_runs_.end(), [&](const auto& a, const auto& b)
+                                     { return openBefore(tree, a->head.node, b->head.node); });
+        double f = tree.node((*best)->head.node).f_score();
+        if (batch.size() >= room && f != layer)
+            break;
+        layer = f;
+        batch.push_back(std::move((*best)->head));
+        if (!advance(**best))
+        {
+            std::cerr << "SEARCH ERROR: Could not read the run file " << (*best)->path << std::endl;
+            return false;
+        }
+        if ((*best)->remaining == 0)
+            open_runs_.erase(best);
+    }
+
+    // Duplicates within the batch: of the equal states, the one popped first is kept
+    std::vector<std::uint64_t> hashes;
+    for (const auto& r : batch)
+        hashes.push_back(hash(r));
+    std::vector<std::size_t> order(batch.size());
+    for (std::size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b)
+    {
+        if (hashes[a] != hashes[b])
+            return hashes[a] < hashes[b];
+        return openBefore(tree, batch[a].node, batch[b].node);
+    });
+    std::vector<StateRecord> sorted;
+    std::vector<std::uint64_t> sorted_hashes;
+    for (auto i : order)
+    {
+        sorted.push_back(std::move(batch[i]));
+        sorted_hashes.push_back(hashes[i]);
+    }
+
+    std::vector<bool> dropped(sorted.size(), false);
+    for (std::size_t i = 0, group = 0; i < sorted.size(); i++)
+    {
+        if (sorted_hashes[i] != sorted_hashes[group])
+            group = i;
+        for (std::size_t j = group; j < i && !dropped[i]; j++)
+            dropped[i] = !dropped[j] && sorted[j] == sorted[i];
+    }
+    if (!dropClosed(tree, sorted, sorted_hashes, dropped))
+    {
+        std::cerr << "SEARCH ERROR: Could not read the closed runs in " << directory_ << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < sorted.size(); i++)
+    {
+        if (dropped[i])
+        {
+            stats_->duplicate_hits++;
+            continue;
+        }
+        SearchData state;
+        for (auto id : sorted[i].subassemblies)
+            state.subassemblies.set(assembly_.getNodeData(id).name, id);
+        for (auto id : sorted[i].actions)
+            state.actions.set(assembly_.getNodeData(id).name, id);
+        state.hash = sorted_hashes[i];
+        state.minimum_cost_action = expander.minimumActionCost(state);
+        tree.restoreState(sorted[i].node, std::move(state));
+
+        const auto& node = tree.node(sorted[i].node);
+        frontier_.push(OpenEntry{node.f_score(), node.g_score, sorted[i].node});
+    }
+    stats_->open_list_peak = std::max(stats_->open_list_peak, frontier_.size());
+    return true;
+}
+
+// The batch and the closed states are both sorted by hash, so every closed run is read once and
+// only up to the largest hash of the batch
+bool ExternalAStarSearch::dropClosed(SearchTree& tree, const std::vector<StateRecord>& batch,
+                                     const std::vector<std::uint64_t>& hashes, std::vector<bool>& dropped)
+{
+    if (batch.empty())
+        return true;
+
+    auto check = [&](const StateRecord& closed, std::uint64_t h)
+    {
+        double g = tree.node(closed.node).g_score;
+        auto it = std::lower_bound(hashes.begin(), hashes.end(), h);
+        for (; it != hashes.end() && *it == h; ++it)
+        {
+            auto i = it - hashes.begin();
+            if (!dropped[i] && g <= tree.node(batch[i].node).g_score && closed == batch[i])
+                dropped[i] = true;
+        }
+    };
+
+    for (const auto& closed : closed_)
+        check(closed, hash(closed));
+
+    for (auto& run : closed_runs_)
+    {
+        RunReader reader;
+        if (!reader.open(run->path))
+            return false;
+        StateRecord closed;
+        for (std::size_t i = 0; i < run->remaining; i++)
+        {
+            if (!reader.next(closed))
+                return false;
+            auto h = hash(closed);
+            if (h > hashes.back())
+                break;
+            check(closed, h);
+        }
+    }
+    return true;
+}
+
+void ExternalAStarSearch::close(SearchTree& tree, NodeIndex id)
+{
+    closed_.push_back(record(id, tree.state(id)));
+    if (closed_.size() >= open_limit_)
+        flushClosed(tree);
+}
+
+// Losing closed states only weakens the duplicate detection, a failed write is not an error
+void ExternalAStarSearch::flushClosed(SearchTree& tree)
+{
+    TRACE_SCOPE("ExternalAStarSearch::flushClosed", "search");
+
+    std::sort(closed_.begin(), closed_.end(), [&](const StateRecord& a, const StateRecord& b)
+              { return closedBefore(tree, a, b); });
+    auto run = writeRun(closed_);
+    closed_.clear();
+    if (run == nullptr)
+        return;
+    // Closed runs are read from their start for every batch, the head is not kept open
+    run->reader = RunReader();
+    closed_runs_.push_back(std::move(run));
+    if (closed_runs_.size() > max_runs)
+    {
+        for (auto& r : closed_runs_)
+            openRun(*r, r->remaining);
+        if (!compact(tree, closed_runs_, true))
+            closed_runs_.clear();
+        else
+            closed_runs_.back()->reader = RunReader();
+    }
+}
+
+// k-way merge of the heads of all runs, streamed into a new run
+bool ExternalAStarSearch::compact(SearchTree& tree, std::vector<std::unique_ptr<Run>>& runs, bool by_hash)
+{
+    TRACE_SCOPE("ExternalAStarSearch::compact", "search");
+
+    auto before = [&](const std::unique_ptr<Run>& a, const std::unique_ptr<Run>& b)
+    {
+        return by_hash ? closedBefore(tree, a->head, b->head) : openBefore(tree, a->head.node, b->head.node);
+    };
+
+    auto merged = std::make_unique<Run>();
+    merged->path = nextPath();
+    RunWriter writer;
+    if (!writer.open(merged->path))
+        return false;
+    std::size_t records = 0;
+    while (!runs.empty())
+    {
+        auto best = std::min_element(runs.begin(), runs.end(), before);
+        writer.write((*best)->head);
+        records++;
+        if (!advance(**best))
+            return false;
+        if ((*best)->remaining == 0)
+            runs.erase(best);
+    }
+    if (!writer.close())
+        return false;
+    stats_->spill_bytes += writer.bytes();
+    if (!openRun(*merged, records))
+        return false;
+    runs.push_back(std::move(merged));
+    return true;
+}
+
+StateRecord ExternalAStarSearch::record(NodeIndex id, const SearchData& state) const
+{
+    StateRecord r;
+    r.node = id;
+    for (const auto& sa : state.subassemblies)
+        r.subassemblies.push_back(sa.second);
+    for (const auto& action : state.actions)
+        r.actions.push_back(action.second);
+    std::sort(r.subassemblies.begin(), r.subassemblies.end());
+    std::sort(r.actions.begin(), r.actions.end());
+    return r;
+}
+
+std::uint64_t ExternalAStarSearch::hash(const StateRecord& r) const
+{
+    std::uint64_t h = 0;
+    for (auto id : r.subassemblies)
+        h ^= assembly_.getNodeData(id).key;
+    for (auto id : r.actions)
+        h ^= assembly_.getNodeData(id).key;
+    return h;
+}
+
+bool ExternalAStarSearch::openBefore(SearchTree& tree, NodeIndex a, NodeIndex b) const
+{
+    const auto& x = tree.node(a);
+    const auto& y = tree.node(b);
+    return OpenEntry{x.f_score(), x.g_score, a} < OpenEntry{y.f_score(), y.g_score, b};
+}
+
+bool ExternalAStarSearch::closedBefore(SearchTree& tree, const StateRecord& a, const StateRecord& b) const
+{
+    auto ha = hash(a);
+    auto hb = hash(b);
+    if (ha != hb)
+        return ha < hb;
+    return openBefore(tree, a.node, b.node);
+}
+
+bool ExternalAStarSearch::openRun(Run& run, std::size_t records)
+{
+    run.reader = RunReader();
+    run.remaining = records;
+    if (!run.reader.open(run.path))
+        return false;
+    return records == 0 || run.reader.next(run.head);
+}
+
+// Move to the next record, the file of an exhausted run is removed
+bool ExternalAStarSearch::advance(Run& run)
+{
+    if (--run.remaining > 0)
+        return run.reader.next(run.head);
+    run.reader = RunReader();
+    std::error_code error;
+    std::filesystem::remove(run.path, error);
+    return true;
+}
+
+std::string ExternalAStarSearch::nextPath()
+{
+    if (files_ == 0)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(directory_, error);
+    }
+    return directory_ + "/run-" + std::to_string(files_++);
+}
+
+std::unique_ptr<ExternalAStarSearch::Run> ExternalAStarSearch::writeRun(const std::vector<StateRecord>& records)
+{
+    auto run = std::make_unique<Run>();
+    run->path = nextPath();
+    RunWriter writer;
+    if (!writer.open(run->path))
+        return nullptr;
+    for (const auto& r : records)
+        writer.write(r);
+    if (!writer.close())
+        return nullptr;
+    stats_->spill_bytes += writer.bytes();
+    if (!openRun(*run, records.size()))
+        return nullptr;
+    return run;
+}
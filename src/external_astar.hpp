@@ -0,0 +1,103 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "astar.hpp"
+#include "runfile.hpp"
+
+// A* search which keeps at most `open_limit` hypernodes of the open list in memory.
+// When the in-memory frontier outgrows the limit, its worse half is written to a new run file in
+// order of the open list and the states are released from the search tree. The runs are merged
+// again once their best entry would be popped: a batch of the best entries of all runs, completed
+// to the end of its f layer, is read back, and the entries of the batch whose state was reached
+// before on a path which is not more expensive are dropped (delayed duplicate detection). The
+// expanded states are kept for this in closed runs sorted by their Zobrist hash, which are scanned
+// together with the batch. Both kinds of runs are only written and read sequentially; when too many
+// of them accumulate they are merged into one.
+//
+// Apart from the dropped duplicates, whose subtrees are reached at a lower cost through the state kept,
+// entries are popped in the order of the in-memory search.
+// The hypernodes themselves (parent, scores and assignments) stay in the search tree, the run files
+// take the states, which hold most of the memory of the open list.
+class ExternalAStarSearch
+{
+  public:
+    // @open_limit: hypernodes of the open list kept in memory, at least 2
+    // @directory:  directory for the run files, the system temporary directory if empty
+    ExternalAStarSearch(Graph<AssemblyData,EdgeData>&, SearchStatistics*, std::size_t open_limit,
+                        std::string directory = "");
+    ExternalAStarSearch(const ExternalAStarSearch&) = delete;
+    // Removes the run files
+    ~ExternalAStarSearch();
+
+    //   \return: index of the goal node, or `SearchTree::none` if every goal exceeds the bound,
+    //            the search was stopped by its control or a run file could not be read
+    NodeIndex search(SearchTree&, NodeIndex, NodeExpander&);
+
+    // Cost of the incumbent plan, see `AStarSearch::setBound`
+    void setBound(double bound, double minimum_cost);
+    // Stop the search on cancellation or at the deadline, and report its progress
+    void setControl(const PlanningControl*);
+
+  private:
+    // Run file being merged, with its next record
+    struct Run
+    {
+        std::string path;
+        RunReader reader;
+        StateRecord head;
+        // Records not read yet, including the head
+        std::size_t remaining = 0;
+    };
+
+    // Write the worse half of the frontier to a new open run
+    void spill(SearchTree&);
+    // Read the best entries of the open runs back into the frontier
+    //   \return: false if a run could not be read
+    bool load(SearchTree&, NodeExpander&);
+    // Drop the records of a batch sorted by hash whose state was expanded with a lower or equal g score
+    //   \return: false if a closed run could not be read
+    bool dropClosed(SearchTree&, const std::vector<StateRecord>&, const std::vector<std::uint64_t>& hashes,
+                    std::vector<bool>& dropped);
+    // Remember the state of an expanded node for the duplicate detection
+    void close(SearchTree&, NodeIndex);
+    void flushClosed(SearchTree&);
+    // Merge all runs of a kind into one
+    //   \return: false if a run could not be read or written
+    bool compact(SearchTree&, std::vector<std::unique_ptr<Run>>&, bool by_hash);
+
+    StateRecord record(NodeIndex, const SearchData&) const;
+    std::uint64_t hash(const StateRecord&) const;
+    // Order of the open list, and the order of the closed runs
+    bool openBefore(SearchTree&, NodeIndex, NodeIndex) const;
+    bool closedBefore(SearchTree&, const StateRecord&, const StateRecord&) const;
+
+    // Start reading a run written by `writeRun`, the run is empty if it has no records
+    bool openRun(Run&, std::size_t records);
+    bool advance(Run&);
+    std::string nextPath();
+    // Write the records to a new run file, in the given order
+    //   \return: the run, nullptr if it could not be written
+    std::unique_ptr<Run> writeRun(const std::vector<StateRecord>&);
+
+    Graph<AssemblyData,EdgeData>& assembly_;
+    SearchStatistics own_stats_;
+    SearchStatistics* stats_;
+    // Heuristic and goal test of the in-memory search
+    AStarSearch astar_;
+    std::size_t open_limit_;
+    std::string directory_;
+    std::size_t files_ = 0;
+    double bound_ = INFINITY;
+    SearchMonitor monitor_;
+
+    DaryHeap<4> frontier_;
+    std::vector<std::unique_ptr<Run>> open_runs_;
+    std::vector<std::unique_ptr<Run>> closed_runs_;
+    // Expanded states not written to a closed run yet
+    std::vector<StateRecord> closed_;
+    // Runs of a kind are merged once there are more than this many
+    static constexpr std::size_t max_runs = 16;
+};
@@ -6,7 +6,6 @@
 #include "node.hpp"
 #include "edge.hpp"
 #include "types.hpp"
-#include "dotwriter.hpp"
 
 template <typename N, typename E>
 class Graph
@@ -15,12 +14,18 @@ class Graph
     // Construction, Destruction
     Graph();
     Graph(const std::size_t, const std::size_t);
-    Graph(const Graph<N,E>&) = default;
+    Graph(const Graph<N,E>&);
+    Graph(Graph<N,E>&&) = default;
+    Graph<N,E>& operator=(const Graph<N,E>&);
+    Graph<N,E>& operator=(Graph<N,E>&&) = default;
     ~Graph() = default;
 
     // General Information
     std::size_t numberOfNodes() const;
     std::size_t numberOfEdges() const;
+    // Ids assigned by the next insertion
+    NodeIndex nextNodeIndex() const;
+    EdgeIndex nextEdgeIndex() const;
     std::size_t numberOfSuccessors(const NodeIndex) const;
     std::size_t numberOfPredecessors(const NodeIndex) const;
     bool hasSuccessor(const NodeIndex) const;
@@ -59,7 +64,7 @@ class Graph
     // Helpers
     std::pair<bool, EdgeIndex> findEdge(const NodeIndex, const NodeIndex) const;
 
-    Node<N>* root;
+    Node<N>* root = nullptr;
 
   private:
     // Nodes
@@ -89,6 +94,32 @@ inline Graph<N, E>::Graph(
 
 }
 
+// Copies point their root to their own node, not to the node of the copied graph
+template <typename N, typename E>
+inline Graph<N, E>::Graph(const Graph<N, E>& other)
+  : nodes_(other.nodes_),
+    free_node_id_(other.free_node_id_),
+    edges_(other.edges_),
+    free_edge_id_(other.free_edge_id_)
+{
+    root = other.root ? &nodes_.at(other.root->id) : nullptr;
+}
+
+template <typename N, typename E>
+inline Graph<N, E>&
+Graph<N, E>::operator=(const Graph<N, E>& other)
+{
+    if (this != &other)
+    {
+        nodes_ = other.nodes_;
+        free_node_id_ = other.free_node_id_;
+        edges_ = other.edges_;
+        free_edge_id_ = other.free_edge_id_;
+        root = other.root ? &nodes_.at(other.root->id) : nullptr;
+    }
+    return *this;
+}
+
 template <typename N, typename E>
 inline std::size_t
 Graph<N, E>::numberOfNodes() const
@@ -103,6 +134,20 @@ Graph<N, E>::numberOfEdges() const
     return edges_.size();
 }
 
+template <typename N, typename E>
+inline NodeIndex
+Graph<N, E>::nextNodeIndex() const
+{
+    return free_node_id_;
+}
+
+template <typename N, typename E>
+inline EdgeIndex
+Graph<N, E>::nextEdgeIndex() const
+{
+    return free_edge_id_;
+}
+
 template <typename N, typename E>
 inline std::size_t
 Graph<N, E>::numberOfSuccessors(
@@ -166,6 +211,13 @@ Graph<N, E>::getNode(NodeIndex node_id)
     return &(nodes_.at(node_id));
 }
 
+template <typename N, typename E>
+inline Edge<E>*
+Graph<N, E>::getEdge(EdgeIndex edge_id)
+{
+    return &(edges_.at(edge_id));
+}
+
 template <typename N, typename E>
 inline N&
 Graph<N, E>::getNodeData(NodeIndex node_id)
@@ -305,6 +357,26 @@ Graph<N, E>::findEdge(
     return std::make_pair(success, edge_index);
 }
 
+// Erase a node together with its incident edges
+template <typename N, typename E>
+bool Graph<N, E>::eraseNode(
+    const NodeIndex node_id)
+{
+    auto it = nodes_.find(node_id);
+    if (it == nodes_.end())
+        return false;
+
+    std::vector<EdgeIndex> incident(it->second.successorEdges().begin(), it->second.successorEdges().end());
+    incident.insert(incident.end(), it->second.predecessorEdges().begin(), it->second.predecessorEdges().end());
+    for (auto edge_id : incident)
+        eraseEdge(edge_id);
+    if (root == &it->second)
+        root = nullptr;
+    nodes_.erase(it);
+
+    return true;
+}
+
 template <typename N, typename E>
 bool Graph<N, E>::eraseEdge(
     const EdgeIndex edge_id)
@@ -0,0 +1,83 @@
+#include "greedy.hpp"
+
+GreedyPlanner::GreedyPlanner(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config)
+  : graph_(graph),
+    config_(config)
+{}
+
+AssemblyPlan GreedyPlanner::solve()
+{
+    TRACE_SCOPE("GreedyPlanner::solve", "search");
+    return plan(graph_.root->id);
+}
+
+AssemblyPlan GreedyPlanner::plan(NodeIndex id)
+{
+    NodeIndex best_action = 0;
+    Symbol best_agent = 0;
+    double best_cost = INFINITY;
+    bool best_feasible = false;
+    for (auto action_id : graph_.successorNodes(id))
+    {
+        for (const auto& agent : config_.agents)
+        {
+            bool feasible;
+            double cost = immediateCost(action_id, agent.first, feasible);
+            if (feasible > best_feasible || (feasible == best_feasible && cost < best_cost))
+            {
+                best_cost = cost;
+                best_feasible = feasible;
+                best_action = action_id;
+                best_agent = agent.first;
+            }
+        }
+    }
+
+    if (std::isinf(best_cost))
+    {
+        AssemblyPlan leaf;
+        leaf.graph.root = leaf.graph.getNode(leaf.graph.insertNode(graph_.getNodeData(id)));
+        return leaf;
+    }
+
+    std::vector<AssemblyPlan> children;
+    for (auto child : graph_.successorNodes(best_action))
+        children.push_back(plan(child));
+    std::vector<const AssemblyPlan*> child_plans;
+    for (const auto& child : children)
+        child_plans.push_back(&child);
+    return composePlan(graph_, config_, id, best_action, best_agent, child_plans);
+}
+
+double GreedyPlanner::immediateCost(NodeIndex action_id, Symbol agent, bool& feasible)
+{
+    double cost = config_.actions.at(graph_.getNodeData(action_id).name).costs.at(agent);
+    feasible = cost < INT_MAX;
+    for (auto child : graph_.successorNodes(action_id))
+    {
+        auto i = cheapestInteraction(config_, graph_.getNodeData(child).name, agent);
+        if (i.first)
+        {
+            double interaction = i.first->costs.at(i.second);
+            cost += interaction;
+            feasible &= interaction < INT_MAX;
+        }
+        feasible = feasible && plannable(child);
+    }
+    return cost;
+}
+
+bool GreedyPlanner::plannable(NodeIndex id)
+{
+    auto it = plannable_.find(id);
+    if (it != plannable_.end())
+        return it->second;
+
+    bool result = !graph_.hasSuccessor(id);
+    for (auto action_id : graph_.successorNodes(id))
+    {
+        for (auto agent = config_.agents.begin(); !result && agent != config_.agents.end(); ++agent)
+            immediateCost(action_id, agent->first, result);
+    }
+    return plannable_[id] = result;
+}
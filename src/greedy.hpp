@@ -0,0 +1,39 @@
+#pragma once
+
+#include <climits>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+#include "plan.hpp"
+#include "trace.hpp"
+#include "types.hpp"
+
+// Fast construction of a feasible plan.
+// Starting at the root, every subassembly is disassembled by the action and agent with the lowest
+// immediate cost, i.e. the action cost plus the interactions the agent needs for the children,
+// without looking further ahead. Infeasible assignments (cost INT_MAX) are skipped, and so are actions
+// whose children cannot be disassembled without one, unless there is no other choice.
+// The child plans are merged into common rounds like in the decomposition. The plan is used as
+// incumbent for the branch-and-bound of the A* search.
+class GreedyPlanner
+{
+  public:
+    GreedyPlanner(Graph<AssemblyData,EdgeData>&, config::Configuration&);
+
+    // Plan the subassembly at the root of the graph
+    AssemblyPlan solve();
+
+  private:
+    AssemblyPlan plan(NodeIndex);
+    // Cost of an action and the interactions the agent needs for its children
+    //   @feasible: set to whether the action and its children can be planned without infeasible assignments
+    double immediateCost(NodeIndex action, Symbol agent, bool& feasible);
+    // Whether the subassembly can be disassembled without infeasible assignments
+    bool plannable(NodeIndex);
+
+    Graph<AssemblyData,EdgeData>& graph_;
+    config::Configuration& config_;
+    std::unordered_map<NodeIndex, bool> plannable_;
+};
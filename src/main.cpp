@@ -1,11 +1,35 @@
 #include <iostream>
+#include <fstream>
+#include <cctype>
 #include <chrono>
+#include <stdexcept>
 
 #include "planner.hpp"
 #include "dotwriter.hpp"
 #include "io.hpp"
+#include "reduction.hpp"
+#include "trace.hpp"
 #include "argparse.hpp"
 
+// Amount of memory with an optional K, M or G suffix, e.g. 4G
+static std::size_t parseBytes(const std::string &value)
+{
+    std::size_t end;
+    double amount = std::stod(value, &end);
+    std::size_t unit = 1;
+    if (end < value.size())
+    {
+        switch (std::toupper(value[end]))
+        {
+        case 'K': unit = std::size_t(1) << 10; break;
+        case 'M': unit = std::size_t(1) << 20; break;
+        case 'G': unit = std::size_t(1) << 30; break;
+        default: throw std::invalid_argument("Unknown unit in " + value);
+        }
+    }
+    return std::size_t(std::max(0.0, amount) * unit);
+}
+
 int main(int argc, char *argv[])
 {
     // Input handling
@@ -24,6 +48,84 @@ int main(int argc, char *argv[])
         .help("Print debug output")
         .default_value(false)
         .implicit_value(true);  
+    program.add_argument("-s", "--stats")
+        .help("Print search statistics and phase timings")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--solver")
+        .help("Planning algorithm [astar: minimal cost per round, aostar: minimal total cost, "
+              "pareto: frontier of total cost and makespan]")
+        .default_value(std::string("astar"));
+    program.add_argument("--no-prune")
+        .help("Disable the branch-and-bound pruning of the A* search")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--suboptimality")
+        .help("Accept plans costing up to this factor more than the optimum, e.g. 1.05, searched by a focal search [1: optimal]")
+        .default_value(1.0)
+        .action([](const std::string &value) { return std::stod(value); });
+    program.add_argument("--dominance")
+        .help("Discard hypernodes dominated by an expanded hypernode with fewer open subassemblies")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--partial-expansion")
+        .help("Generate the children of a hypernode lazily in order of their cost")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("-k", "--alternatives")
+        .help("Number of distinct plans to write, the n-th best one to <output>_<n>")
+        .default_value(1)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--open-limit")
+        .help("Keep at most this many hypernodes of the A* open list in memory and spill the rest to disk [0: no limit]")
+        .default_value(0)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--spill-dir")
+        .help("Directory of the run files written with --open-limit [default: system temporary directory]")
+        .default_value(std::string(""));
+    program.add_argument("--max-memory")
+        .help("Search within this much memory with SMA*, with an optional K, M or G suffix, e.g. 4G [0: no limit]")
+        .default_value(std::size_t(0))
+        .action([](const std::string &value) { return parseBytes(value); });
+    program.add_argument("--checkpoint")
+        .help("Periodically write the state of the A* search to this file")
+        .default_value(std::string(""));
+    program.add_argument("--checkpoint-interval")
+        .help("Seconds between two checkpoints")
+        .default_value(300)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--resume")
+        .help("Continue the A* search from a checkpoint written for the same input")
+        .default_value(std::string(""));
+    program.add_argument("--decompose")
+        .help("Plan independent subassemblies separately and in parallel")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("--decompose-threshold")
+        .help("Search subassemblies with at most this many actions below them as a whole")
+        .default_value(12)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("-j", "--threads")
+        .help("Number of worker threads used by the decomposition [0: all hardware threads]")
+        .default_value(0)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--time-limit")
+        .help("Stop the search after the given milliseconds and write the best plan found [0: no limit]")
+        .default_value(0)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--progress")
+        .help("Plan only the work remaining after the completed subassemblies and running actions in the given XML")
+        .default_value(std::string(""));
+    program.add_argument("--reduce")
+        .help("Remove dominated actions and unreachable nodes from the graph before planning")
+        .default_value(false)
+        .implicit_value(true);
+    program.add_argument("-t", "--trace")
+        .help("Write a Chrome trace-event file of the planning phases")
+        .default_value(std::string(""));
+    program.add_argument("--stats-json")
+        .help("Write search statistics and phase timings to the given JSON file")
+        .default_value(std::string(""));
     try
     {
         program.parse_args(argc, argv);
@@ -36,6 +138,9 @@ int main(int argc, char *argv[])
     }
     auto input_path = program.get<std::string>("input");
     auto output_path = program.get<std::string>("output");
+    auto trace_path = program.get<std::string>("--trace");
+    if (!trace_path.empty())
+        Tracer::instance().enable();
 
     std::cout << "+---------------------------------------------------+\n";
     std::cout << "|                 ASSEMBLY PLANNER                  |\n";
@@ -47,9 +152,10 @@ int main(int argc, char *argv[])
     IoXml xml;
     config::Configuration config;
     bool result;
+    SearchStatistics io_stats;
 
     // Read input XML
-    std::tie(assembly, config, result) = xml.read(input_path);
+    std::tie(assembly, config, result) = xml.read(input_path, &io_stats);
     if (!result)
     {
         std::cout << "ERROR: Could not read " << input_path << std::endl;
@@ -58,19 +164,114 @@ int main(int argc, char *argv[])
     if(program.get<bool>("--verbose"))
         std::cout << config << std::endl;
 
+    // Continue a partially executed plan
+    auto progress_path = program.get<std::string>("--progress");
+    if (!progress_path.empty())
+    {
+        auto progress = xml.readProgress(progress_path);
+        if (!progress || !applyProgress(assembly, progress.value()))
+        {
+            std::cout << "ERROR: Could not apply the progress in " << progress_path << std::endl;
+            return 1;
+        }
+    }
+
+    // Remove alternatives which cannot improve the plan
+    if (program.get<bool>("--reduce"))
+    {
+        ScopedPhase phase(&io_stats, "reduce");
+        std::cout << reduceGraph(assembly, config) << std::endl;
+    }
+
     // Run planner
-    Planner planner;
-    auto assembly_plan = planner(assembly, config);
+    PlannerOptions options;
+    auto solver = program.get<std::string>("--solver");
+    if (solver == "aostar")
+    {
+        options.solver = SolverType::AOSTAR;
+    }
+    else if (solver == "pareto")
+    {
+        options.solver = SolverType::PARETO;
+    }
+    else if (solver != "astar")
+    {
+        std::cout << "ERROR: Unknown solver " << solver << std::endl;
+        return 1;
+    }
+    options.prune = !program.get<bool>("--no-prune");
+    options.partial_expansion = program.get<bool>("--partial-expansion");
+    options.dominance = program.get<bool>("--dominance");
+    options.suboptimality = std::max(1.0, program.get<double>("--suboptimality"));
+    options.alternatives = std::max(1, program.get<int>("--alternatives"));
+    options.open_limit = std::max(0, program.get<int>("--open-limit"));
+    options.spill_directory = program.get<std::string>("--spill-dir");
+    options.memory_limit = program.get<std::size_t>("--max-memory");
+    options.checkpoint_path = program.get<std::string>("--checkpoint");
+    options.checkpoint_interval = std::chrono::seconds(std::max(0, program.get<int>("--checkpoint-interval")));
+    options.resume_path = program.get<std::string>("--resume");
+    options.decompose = program.get<bool>("--decompose");
+    options.decompose_threshold = std::max(0, program.get<int>("--decompose-threshold"));
+    options.threads = std::max(0, program.get<int>("--threads"));
+    auto time_limit = program.get<int>("--time-limit");
+    if (time_limit > 0)
+        options.control.deadline = PlanningControl::Clock::now() + std::chrono::milliseconds(time_limit);
 
-    // Output result
-    if(program.get<bool>("--dot"))
+    Planner planner(options);
+    planner(assembly, config);
+    if (planner.status == PlanningStatus::DEADLINE)
+        std::cout << "Time limit reached, the best plan found so far is written" << std::endl;
+
+    // Output result, alternatives are written next to the best plan
+    SearchStatistics stats = planner.statistics;
     {
-        DotWriter dot;
-        dot.write(assembly_plan, output_path);
+        ScopedPhase phase(&stats, "write");
+        for (std::size_t i = 0; i < planner.plans.size(); i++)
+        {
+            auto path = output_path;
+            if (i > 0)
+            {
+                auto dot = path.find_last_of('.');
+                auto slash = path.find_last_of('/');
+                if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+                    dot = path.size();
+                path.insert(dot, "_" + std::to_string(i + 1));
+            }
+
+            auto &assembly_plan = planner.plans[i].graph;
+            if(program.get<bool>("--dot"))
+            {
+                DotWriter dot;
+                dot.write(assembly_plan, path);
+            }
+            else
+            {
+                xml.write(assembly_plan, path, &planner.schedules[i]);
+            }
+        }
     }
-    else
+    // Reading happens before planning, report the phases in order of execution
+    stats.phases.insert(stats.phases.begin(), io_stats.phases.begin(), io_stats.phases.end());
+
+    if(program.get<bool>("--stats"))
+        stats.print(std::cout);
+
+    auto stats_path = program.get<std::string>("--stats-json");
+    if(!stats_path.empty())
+    {
+        std::ofstream fs(stats_path);
+        if (!fs)
+        {
+            std::cout << "ERROR: Could not write " << stats_path << std::endl;
+            return 1;
+        }
+        stats.writeJson(fs);
+    }
+
+    if (!trace_path.empty() && !Tracer::instance().write(trace_path))
     {
-        xml.write(assembly_plan, output_path);
+        std::cout << "ERROR: Could not write " << trace_path << std::endl;
+        return 1;
     }
 
     std::cout << "+---------------------------------------------------+" << std::endl;
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "types.hpp"
+
+// Entry of the A* open list. Entries are stored by value, so ordering the list
+// never has to dereference the hypernodes themselves.
+struct OpenEntry
+{
+    double f_score;
+    double g_score;
+    NodeIndex index;
+};
+
+// Deterministic ordering: lowest f first, ties broken towards higher g (deeper nodes),
+// remaining ties towards the node generated first.
+inline bool operator<(const OpenEntry &lhs, const OpenEntry &rhs)
+{
+    if (lhs.f_score != rhs.f_score)
+        return lhs.f_score < rhs.f_score;
+    if (lhs.g_score != rhs.g_score)
+        return lhs.g_score > rhs.g_score;
+    return lhs.index < rhs.index;
+}
+
+enum class OpenListType
+{
+    DARY_HEAP,
+    BUCKET
+};
+
+// Interface of the open list used by the `AStarSearch`
+struct OpenList
+{
+    virtual ~OpenList() = default;
+
+    virtual void push(const OpenEntry &) = 0;
+    // Remove and return the best entry, the list must not be empty
+    virtual OpenEntry pop() = 0;
+    virtual const OpenEntry &top() const = 0;
+    virtual bool empty() const = 0;
+    virtual std::size_t size() const = 0;
+    // Copy of all entries in unspecified order, e.g. to store the list in a checkpoint
+    virtual std::vector<OpenEntry> entries() const = 0;
+};
+
+// Implicit d-ary min-heap. A branching factor of four halves the depth of a binary heap,
+// and the children of a node share one or two cache lines.
+template <std::size_t D>
+struct DaryHeap : OpenList
+{
+    void push(const OpenEntry &) override;
+    OpenEntry pop() override;
+    const OpenEntry &top() const override;
+    bool empty() const override;
+    std::size_t size() const override;
+    std::vector<OpenEntry> entries() const override;
+
+  private:
+    void siftUp(std::size_t);
+    void siftDown(std::size_t);
+
+    std::vector<OpenEntry> heap_;
+};
+
+template <std::size_t D>
+inline void DaryHeap<D>::push(const OpenEntry &entry)
+{
+    heap_.push_back(entry);
+    siftUp(heap_.size() - 1);
+}
+
+template <std::size_t D>
+inline OpenEntry DaryHeap<D>::pop()
+{
+    OpenEntry best = heap_.front();
+    heap_.front() = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty())
+        siftDown(0);
+    return best;
+}
+
+template <std::size_t D>
+inline const OpenEntry &DaryHeap<D>::top() const
+{
+    return heap_.front();
+}
+
+template <std::size_t D>
+inline bool DaryHeap<D>::empty() const
+{
+    return heap_.empty();
+}
+
+template <std::size_t D>
+inline std::size_t DaryHeap<D>::size() const
+{
+    return heap_.size();
+}
+
+template <std::size_t D>
+inline std::vector<OpenEntry> DaryHeap<D>::entries() const
+{
+    return heap_;
+}
+
+template <std::size_t D>
+inline void DaryHeap<D>::siftUp(std::size_t pos)
+{
+    OpenEntry entry = heap_[pos];
+    while (pos > 0)
+    {
+        std::size_t parent = (pos - 1) / D;
+        if (!(entry < heap_[parent]))
+            break;
+        heap_[pos] = heap_[parent];
+        pos = parent;
+    }
+    heap_[pos] = entry;
+}
+
+template <std::size_t D>
+inline void DaryHeap<D>::siftDown(std::size_t pos)
+{
+    OpenEntry entry = heap_[pos];
+    const std::size_t n = heap_.size();
+    while (true)
+    {
+        std::size_t first = pos * D + 1;
+        if (first >= n)
+            break;
+        std::size_t last = std::min(first + D, n);
+        std::size_t best = first;
+        for (std::size_t c = first + 1; c < last; c++)
+        {
+            if (heap_[c] < heap_[best])
+                best = c;
+        }
+        if (!(heap_[best] < entry))
+            break;
+        heap_[pos] = heap_[best];
+        pos = best;
+    }
+    heap_[pos] = entry;
+}
+
+// Bucket queue for configurations with integer action costs.
+// Entries are grouped into buckets of unit width by the integer part of their f-score, so most
+// operations only touch the small heap of the front bucket. Scores are not required to be
+// integral or monotone: the exact order within a bucket is kept by a binary heap, buckets are
+// prepended if a lower score arrives, and scores far beyond the window go to an overflow heap.
+struct BucketQueue : OpenList
+{
+    void push(const OpenEntry &) override;
+    OpenEntry pop() override;
+    const OpenEntry &top() const override;
+    bool empty() const override;
+    std::size_t size() const override;
+    std::vector<OpenEntry> entries() const override;
+
+  private:
+    // Maximum number of buckets, keys beyond are kept in `overflow_`
+    static constexpr long max_buckets_ = 1 << 16;
+    // Largest integer f-score of the front bucket, higher scores only go to `overflow_`
+    static constexpr double max_base_ = 1e15;
+
+    static bool greater(const OpenEntry &lhs, const OpenEntry &rhs) { return rhs < lhs; }
+    bool frontIsBest() const;
+
+    // Buckets, the front bucket is never empty while `count_` > 0 (except for the overflow)
+    std::deque<std::vector<OpenEntry>> buckets_;
+    // Integer f-score of the front bucket
+    long base_ = 0;
+    std::size_t count_ = 0;
+    DaryHeap<4> overflow_;
+};
+
+inline void BucketQueue::push(const OpenEntry &entry)
+{
+    // The window is checked before the score is converted to an integer, which is undefined for
+    // scores beyond the range of `long`
+    double score = std::floor(entry.f_score);
+    double offset = buckets_.empty() ? 0 : score - base_;
+    if (!std::isfinite(score) || (buckets_.empty() && std::abs(score) > max_base_) || offset >= max_buckets_ ||
+        (offset < 0 && -offset + buckets_.size() > max_buckets_))
+    {
+        overflow_.push(entry);
+        count_++;
+        return;
+    }
+    if (buckets_.empty())
+        base_ = static_cast<long>(score);
+
+    long idx = static_cast<long>(offset);
+    if (idx < 0)
+    {
+        buckets_.insert(buckets_.begin(), static_cast<std::size_t>(-idx), std::vector<OpenEntry>());
+        base_ += idx;
+        idx = 0;
+    }
+    if (idx >= static_cast<long>(buckets_.size()))
+        buckets_.resize(idx + 1);
+
+    auto &bucket = buckets_[idx];
+    bucket.push_back(entry);
+    std::push_heap(bucket.begin(), bucket.end(), greater);
+    count_++;
+}
+
+// Whether the best entry is in the front bucket rather than the overflow heap
+inline bool BucketQueue::frontIsBest() const
+{
+    if (buckets_.empty())
+        return false;
+    if (overflow_.empty())
+        return true;
+    return buckets_.front().front() < overflow_.top();
+}
+
+inline OpenEntry BucketQueue::pop()
+{
+    count_--;
+    if (!frontIsBest())
+        return overflow_.pop();
+
+    auto &bucket = buckets_.front();
+    std::pop_heap(bucket.begin(), bucket.end(), greater);
+    OpenEntry best = bucket.back();
+    bucket.pop_back();
+
+    // Drop empty buckets so that the front bucket holds the minimum again
+    while (!buckets_.empty() && buckets_.front().empty())
+    {
+        buckets_.pop_front();
+        base_++;
+    }
+    return best;
+}
+
+inline const OpenEntry &BucketQueue::top() const
+{
+    if (!frontIsBest())
+        return overflow_.top();
+    return buckets_.front().front();
+}
+
+inline bool BucketQueue::empty() const
+{
+    return count_ == 0;
+}
+
+inline std::size_t BucketQueue::size() const
+{
+    return count_;
+}
+
+inline std::vector<OpenEntry> BucketQueue::entries() const
+{
+    auto entries = overflow_.entries();
+    for (const auto &bucket : buckets_)
+        entries.insert(entries.end(), bucket.begin(), bucket.end());
+    return entries;
+}
+
+// Choose the open list for a configuration: the bucket queue pays off if all finite action costs
+// are integral and small enough for the f-scores to spread over a bounded number of buckets.
+inline OpenListType detectOpenListType(const config::Configuration &config)
+{
+    for (const auto &action : config.actions)
+    {
+        for (const auto &agent_cost : action.second.costs)
+        {
+            double cost = agent_cost.second;
+            // Infeasible assignments [inf] are stored as INT_MAX and do not decide the type
+            if (cost >= INT_MAX)
+                continue;
+            if (cost != std::floor(cost) || cost < 0 || cost > (1 << 16))
+                return OpenListType::DARY_HEAP;
+        }
+    }
+    return OpenListType::BUCKET;
+}
+
+inline std::unique_ptr<OpenList> makeOpenList(OpenListType type)
+{
+    if (type == OpenListType::BUCKET)
+        return std::make_unique<BucketQueue>();
+    return std::make_unique<DaryHeap<4>>();
+}
+
+// Open list of the bounded-suboptimal focal search. Entries are ordered by their f score as in the
+// other lists; the focal list holds the ones whose f score is within `weight` times the lowest, and
+// `pop` takes the entry with the lowest secondary key among them. With an admissible f score, the
+// lowest one is a lower bound on the optimal cost, so a popped goal costs at most `weight` times as much.
+class FocalList
+{
+  public:
+    explicit FocalList(double weight);
+
+    // @secondary: key of the focal order, lower is better, ties are ordered as in the open list
+    void push(const OpenEntry &, double secondary);
+    // Remove and return the focal entry with the lowest secondary key, the list must not be empty
+    OpenEntry pop();
+    bool empty() const;
+    std::size_t size() const;
+    // Lowest f score of all entries, the list must not be empty
+    double minimumScore() const;
+
+  private:
+    struct Entry
+    {
+        OpenEntry entry;
+        double secondary;
+    };
+    struct ByScore
+    {
+        bool operator()(const Entry &lhs, const Entry &rhs) const { return lhs.entry < rhs.entry; }
+    };
+    struct BySecondary
+    {
+        bool operator()(const Entry &lhs, const Entry &rhs) const
+        {
+            if (lhs.secondary != rhs.secondary)
+                return lhs.secondary < rhs.secondary;
+            return lhs.entry < rhs.entry;
+        }
+    };
+
+    // Move the entries within the current limit to the focal list
+    void refresh();
+
+    double weight_;
+    std::set<Entry, ByScore> open_;
+    // Every entry of `open_` with an f score up to `limit_` is also in `focal_`. Entries above the limit,
+    // after the lowest f score dropped, are only removed once they reach the front.
+    std::set<Entry, BySecondary> focal_;
+    double limit_ = -INFINITY;
+};
+
+inline FocalList::FocalList(double weight)
+  : weight_(weight)
+{}
+
+inline void FocalList::push(const OpenEntry &entry, double secondary)
+{
+    open_.insert(Entry{entry, secondary});
+    if (entry.f_score <= limit_)
+        focal_.insert(Entry{entry, secondary});
+}
+
+inline void FocalList::refresh()
+{
+    double limit = weight_ * minimumScore();
+    if (limit > limit_)
+    {
+        // First entry above the old limit, entries of equal f score come before it by their g score
+        auto it = open_.lower_bound(Entry{OpenEntry{limit_, -INFINITY, NodeIndex(-1)}, 0});
+        for (; it != open_.end() && it->entry.f_score <= limit; ++it)
+            focal_.insert(*it);
+    }
+    limit_ = limit;
+    while (focal_.begin()->entry.f_score > limit_)
+        focal_.erase(focal_.begin());
+}
+
+inline OpenEntry FocalList::pop()
+{
+    refresh();
+    auto best = *focal_.begin();
+    focal_.erase(focal_.begin());
+    open_.erase(best);
+    return best.entry;
+}
+
+inline bool FocalList::empty() const
+{
+    return open_.empty();
+}
+
+inline std::size_t FocalList::size() const
+{
+    return open_.size();
+}
+
+inline double FocalList::minimumScore() const
+{
+    return open_.begin()->entry.f_score;
+}
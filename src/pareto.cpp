@@ -0,0 +1,207 @@
+#include "pareto.hpp"
+
+ParetoSearch::ParetoSearch(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                           SearchStatistics* stats, const PlanningControl* control)
+  : graph_(graph),
+    config_(config),
+    stats_(stats ? stats : &own_stats_),
+    monitor_(control)
+{}
+
+bool ParetoSearch::LabelSet::dominates(double c, double m) const
+{
+    bool dominated = false;
+    for (std::size_t i = 0; i < cost.size(); i++)
+        dominated |= (cost[i] <= c) & (makespan[i] <= m);
+    return dominated;
+}
+
+template <typename F>
+void ParetoSearch::LabelSet::removeDominated(double c, double m, F f)
+{
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < cost.size(); i++)
+    {
+        if (c <= cost[i] && m <= makespan[i])
+        {
+            f(node[i]);
+            continue;
+        }
+        cost[kept] = cost[i];
+        makespan[kept] = makespan[i];
+        node[kept] = node[i];
+        kept++;
+    }
+    cost.resize(kept);
+    makespan.resize(kept);
+    node.resize(kept);
+}
+
+double ParetoSearch::cost(NodeIndex id) const
+{
+    return cost_.at(id);
+}
+
+double ParetoSearch::makespan(NodeIndex id) const
+{
+    return makespan_.at(id);
+}
+
+bool ParetoSearch::isGoal(const SearchData& state)
+{
+    for (const auto& sa : state.subassemblies)
+    {
+        if (graph_.hasSuccessor(sa.second))
+            return false;
+    }
+    return true;
+}
+
+std::pair<double, double> ParetoSearch::heuristic(const SearchData& state)
+{
+    double cost = 0;
+    double makespan = 0;
+    for (const auto& sa : state.subassemblies)
+    {
+        if (!graph_.hasSuccessor(sa.second))
+            continue;
+        double cheapest = INFINITY;
+        for (auto action : graph_.successorNodes(sa.second))
+        {
+            for (const auto& agent_cost : config_.actions[graph_.getNodeData(action).name].costs)
+                cheapest = std::min(cheapest, agent_cost.second);
+        }
+        cost += cheapest;
+        makespan = std::max(makespan, cheapest);
+    }
+    return std::make_pair(cost, makespan);
+}
+
+std::vector<NodeIndex> ParetoSearch::key(const SearchData& state)
+{
+    std::vector<NodeIndex> key;
+    for (const auto& sa : state.subassemblies)
+    {
+        if (graph_.hasSuccessor(sa.second))
+            key.push_back(sa.second);
+    }
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
+// Perform the multi-objective search:
+//   @tree:     search tree containing the root, children are appended by the expander.
+//   @root:     index of the node at which the search should begin.
+//   @expander: exapnder object used for node expansion.
+//   \return:   goal nodes of the Pareto frontier, the part found so far if the search was stopped
+//
+std::vector<NodeIndex> ParetoSearch::search(SearchTree& tree, NodeIndex root, NodeExpander& expander)
+{
+    TRACE_SCOPE("ParetoSearch::search", "search");
+
+    struct KeyHash
+    {
+        std::size_t operator()(const std::vector<NodeIndex>& key) const
+        {
+            std::size_t h = key.size();
+            for (auto id : key)
+                h ^= std::hash<NodeIndex>()(id) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    std::unordered_map<std::vector<NodeIndex>, LabelSet, KeyHash> labels;
+    std::priority_queue<Entry, std::vector<Entry>, Later> open;
+    // Objectives of the goals found so far, a Pareto set itself
+    LabelSet goals;
+
+    cost_.assign(tree.size(), 0);
+    makespan_.assign(tree.size(), 0);
+    removed_.assign(tree.size(), false);
+
+    auto h = heuristic(tree.state(root));
+    labels[key(tree.state(root))] = LabelSet{{0}, {0}, {root}};
+    open.push(Entry{h.first, h.second, root});
+    stats_->nodes_generated++;
+
+    while (!open.empty())
+    {
+        if (monitor_.poll([&]
+            {
+                double incumbent = goals.cost.empty() ? INFINITY : goals.cost.front();
+                return SearchProgress{stats_->nodes_expanded, open.top().f_cost, incumbent};
+            }))
+            break;
+
+        auto entry = open.top();
+        open.pop();
+        auto current = entry.index;
+        if (removed_[current])
+            continue;
+        if (goals.dominates(entry.f_cost, entry.f_makespan))
+        {
+            stats_->nodes_pruned++;
+            tree.releaseState(current);
+            continue;
+        }
+
+        if (isGoal(tree.state(current)))
+        {
+            goals.cost.push_back(cost_[current]);
+            goals.makespan.push_back(makespan_[current]);
+            goals.node.push_back(current);
+            continue;
+        }
+
+        std::pair<NodeIndex, NodeIndex> children;
+        {
+            TRACE_SCOPE("NodeExpander::expandNode", "search");
+            children = expander.expandNode(current);
+        }
+        tree.releaseState(current);
+
+        cost_.resize(tree.size(), 0);
+        makespan_.resize(tree.size(), 0);
+        removed_.resize(tree.size(), false);
+
+        for (NodeIndex child = children.first; child < children.second; child++)
+        {
+            // The expander scores the mean cost of a round, the objectives are taken from the assignments
+            double round_cost = 0;
+            double round_duration = 0;
+            for (const auto& assignment : tree.assignment(child).planned_assignments)
+            {
+                double c = config_.actions[assignment.action].costs[assignment.agent];
+                round_cost += c;
+                round_duration = std::max(round_duration, c);
+            }
+            cost_[child] = cost_[current] + round_cost;
+            makespan_[child] = makespan_[current] + round_duration;
+
+            auto h = heuristic(tree.state(child));
+            double f_cost = cost_[child] + h.first;
+            double f_makespan = makespan_[child] + h.second;
+
+            auto& set = labels[key(tree.state(child))];
+            if (std::isinf(f_cost) || goals.dominates(f_cost, f_makespan) ||
+                set.dominates(cost_[child], makespan_[child]))
+            {
+                stats_->nodes_pruned++;
+                tree.releaseState(child);
+                continue;
+            }
+            set.removeDominated(cost_[child], makespan_[child], [&](NodeIndex node)
+            {
+                removed_[node] = true;
+                tree.releaseState(node);
+                stats_->nodes_pruned++;
+            });
+            set.cost.push_back(cost_[child]);
+            set.makespan.push_back(makespan_[child]);
+            set.node.push_back(child);
+            open.push(Entry{f_cost, f_makespan, child});
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, open.size());
+    }
+
+    return goals.node;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "control.hpp"
+#include "expander.hpp"
+#include "search_tree.hpp"
+#include "statistics.hpp"
+#include "trace.hpp"
+
+// Multi-objective search over the hypernodes, minimizing the total action cost and the makespan.
+// The makespan of a path is estimated by executing its rounds one after the other, each taking as
+// long as its longest action; both objectives add up along a path. Following NAMOA*, every distinct
+// state (set of open subassemblies) keeps the Pareto set of the labels (cost, makespan) of the paths
+// reaching it, and a new label is dropped if a label of its state or a found plan dominates it.
+// Labels are expanded in lexicographic order of their f values, so every goal popped from the open
+// list belongs to the Pareto frontier.
+//
+// Interaction subassemblies are created anew for every expansion, states containing them are
+// therefore only compared with labels of the same path.
+class ParetoSearch
+{
+  public:
+    ParetoSearch(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchStatistics* stats = nullptr,
+                 const PlanningControl* control = nullptr);
+
+    // Goals of the Pareto-optimal plans, in order of increasing cost and decreasing makespan
+    std::vector<NodeIndex> search(SearchTree&, NodeIndex, NodeExpander&);
+
+    // Objectives of the path to a hypernode of the last search
+    double cost(NodeIndex) const;
+    double makespan(NodeIndex) const;
+
+  private:
+    // Non-dominated labels of one state. The objectives are stored in separate arrays,
+    // so the dominance tests are plain loops over contiguous doubles which the compiler vectorizes.
+    struct LabelSet
+    {
+        std::vector<double> cost;
+        std::vector<double> makespan;
+        std::vector<NodeIndex> node;
+
+        // True if a label is at most as expensive in both objectives
+        bool dominates(double c, double m) const;
+        // Remove the labels which are at least as expensive in both objectives, calls `f` for each of them
+        template <typename F>
+        void removeDominated(double c, double m, F f);
+    };
+
+    struct Entry
+    {
+        double f_cost;
+        double f_makespan;
+        NodeIndex index;
+    };
+
+    struct Later
+    {
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            if (a.f_cost != b.f_cost)
+                return a.f_cost > b.f_cost;
+            if (a.f_makespan != b.f_makespan)
+                return a.f_makespan > b.f_makespan;
+            return a.index > b.index;
+        }
+    };
+
+    bool isGoal(const SearchData&);
+    // Cheapest action of every open subassembly, summed for the cost and maximized for the makespan
+    std::pair<double, double> heuristic(const SearchData&);
+    std::vector<NodeIndex> key(const SearchData&);
+
+    Graph<AssemblyData,EdgeData>& graph_;
+    config::Configuration& config_;
+    SearchStatistics own_stats_;
+    SearchStatistics* stats_;
+    SearchMonitor monitor_;
+
+    // Objectives per hypernode of the search tree
+    std::vector<double> cost_;
+    std::vector<double> makespan_;
+    // Hypernodes whose label was removed from its state while it was still in the open list
+    std::vector<bool> removed_;
+};
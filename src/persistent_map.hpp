@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "symbols.hpp"
+
+// Map from interned names to graph nodes with structural sharing, used for the states of the search.
+// The entries are spread over 32 buckets by their name. Buckets are immutable and shared by every map
+// copied from the one which created them; writing to a map replaces only the affected bucket. A child
+// state copied from its parent therefore shares all buckets its assignment does not touch, and owns
+// memory in proportion to the subassemblies and actions it changes.
+// Iteration visits the buckets in order and the entries of a bucket sorted by name.
+class PersistentMap
+{
+  public:
+    using value_type = std::pair<Symbol, std::size_t>;
+
+    struct Bucket
+    {
+        // Sorted by name
+        std::vector<value_type> entries;
+    };
+
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+        reference operator*() const { return (*bucket_)->entries[entry_]; }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++();
+        const_iterator operator++(int) { auto it = *this; ++*this; return it; }
+        bool operator==(const const_iterator& o) const { return bucket_ == o.bucket_ && entry_ == o.entry_; }
+        bool operator!=(const const_iterator& o) const { return !(*this == o); }
+
+      private:
+        friend class PersistentMap;
+        using BucketIterator = std::vector<std::shared_ptr<const Bucket>>::const_iterator;
+        explicit const_iterator(BucketIterator bucket) : bucket_(bucket) {}
+
+        BucketIterator bucket_;
+        std::size_t entry_ = 0;
+    };
+
+    const_iterator begin() const { return const_iterator(buckets_.begin()); }
+    const_iterator end() const { return const_iterator(buckets_.end()); }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Node of the name, nullptr if the map has no entry for it
+    const std::size_t* find(Symbol) const;
+    // Insert or overwrite an entry
+    //   \return: the node previously stored for the name
+    std::optional<std::size_t> set(Symbol, std::size_t);
+    // Remove an entry
+    //   \return: the node stored for the name, if there was one
+    std::optional<std::size_t> erase(Symbol);
+
+    bool operator==(const PersistentMap&) const;
+    bool operator!=(const PersistentMap& o) const { return !(*this == o); }
+
+    // Heap memory of the map which is not shared with any other map
+    std::size_t ownedBytes() const;
+
+  private:
+    static constexpr unsigned width = 32;
+
+    static unsigned slot(Symbol name) { return name & (width - 1); }
+    // Position of the bucket of a slot in `buckets_`
+    std::size_t position(unsigned slot) const { return __builtin_popcount(bitmap_ & ((1u << slot) - 1)); }
+
+    // Slots with a non-empty bucket, the buckets are stored in the order of their slots
+    std::uint32_t bitmap_ = 0;
+    std::vector<std::shared_ptr<const Bucket>> buckets_;
+    std::size_t size_ = 0;
+};
+
+inline PersistentMap::const_iterator& PersistentMap::const_iterator::operator++()
+{
+    if (++entry_ == (*bucket_)->entries.size())
+    {
+        ++bucket_;
+        entry_ = 0;
+    }
+    return *this;
+}
+
+inline const std::size_t* PersistentMap::find(Symbol name) const
+{
+    auto s = slot(name);
+    if (!(bitmap_ & (1u << s)))
+        return nullptr;
+    const auto& entries = buckets_[position(s)]->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), name,
+                               [](const value_type& e, Symbol n) { return e.first < n; });
+    return it != entries.end() && it->first == name ? &it->second : nullptr;
+}
+
+inline std::optional<std::size_t> PersistentMap::set(Symbol name, std::size_t node)
+{
+    auto s = slot(name);
+    auto p = position(s);
+    if (!(bitmap_ & (1u << s)))
+    {
+        bitmap_ |= 1u << s;
+        buckets_.insert(buckets_.begin() + p, std::make_shared<const Bucket>(Bucket{{value_type(name, node)}}));
+        size_++;
+        return std::nullopt;
+    }
+
+    // Copy on write, the old bucket stays with the maps sharing it
+    auto bucket = std::make_shared<Bucket>(*buckets_[p]);
+    auto& entries = bucket->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), name,
+                               [](const value_type& e, Symbol n) { return e.first < n; });
+    std::optional<std::size_t> previous;
+    if (it != entries.end() && it->first == name)
+    {
+        previous = it->second;
+        it->second = node;
+    }
+    else
+    {
+        entries.insert(it, value_type(name, node));
+        size_++;
+    }
+    buckets_[p] = std::move(bucket);
+    return previous;
+}
+
+inline std::optional<std::size_t> PersistentMap::erase(Symbol name)
+{
+    auto s = slot(name);
+    if (!(bitmap_ & (1u << s)))
+        return std::nullopt;
+    auto p = position(s);
+    const auto& entries = buckets_[p]->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), name,
+                               [](const value_type& e, Symbol n) { return e.first < n; });
+    if (it == entries.end() || it->first != name)
+        return std::nullopt;
+
+    std::optional<std::size_t> previous = it->second;
+    size_--;
+    if (entries.size() == 1)
+    {
+        bitmap_ &= ~(1u << s);
+        buckets_.erase(buckets_.begin() + p);
+        return previous;
+    }
+    auto bucket = std::make_shared<Bucket>();
+    bucket->entries.reserve(entries.size() - 1);
+    bucket->entries.insert(bucket->entries.end(), entries.begin(), it);
+    bucket->entries.insert(bucket->entries.end(), it + 1, entries.end());
+    buckets_[p] = std::move(bucket);
+    return previous;
+}
+
+inline bool PersistentMap::operator==(const PersistentMap& o) const
+{
+    if (size_ != o.size_ || bitmap_ != o.bitmap_)
+        return false;
+    for (std::size_t i = 0; i < buckets_.size(); i++)
+    {
+        if (buckets_[i] != o.buckets_[i] && buckets_[i]->entries != o.buckets_[i]->entries)
+            return false;
+    }
+    return true;
+}
+
+// Buckets referenced by this map only, plus the bucket table and the control blocks of the shared pointers
+inline std::size_t PersistentMap::ownedBytes() const
+{
+    constexpr std::size_t control = 2 * sizeof(long) + sizeof(void*);
+    std::size_t bytes = buckets_.capacity() * sizeof(buckets_[0]);
+    for (const auto& bucket : buckets_)
+    {
+        if (bucket.use_count() == 1)
+            bytes += control + sizeof(Bucket) + bucket->entries.capacity() * sizeof(value_type);
+    }
+    return bytes;
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph.hpp"
+#include "types.hpp"
+
+// Assembly plan produced by the planner.
+// The graph contains the selected subassemblies and actions (with their assigned agents),
+// the rounds list the assignments executed together, starting with the first one to execute.
+// The `action_node_id` of every assignment refers to the node in `graph`.
+using PlanRounds = std::vector<std::vector<AgentActionAssignment>>;
+
+struct AssemblyPlan
+{
+    Graph<AssemblyData,EdgeData> graph;
+    PlanRounds rounds;
+    // Sum of the costs of all assigned actions
+    double cost = 0;
+
+    // Print the rounds and the total cost
+    void print(std::ostream&) const;
+
+    // Objective minimized by the A* search: the sum over all rounds of the mean action cost
+    double roundCost(const config::Configuration&) const;
+
+    // Sorted action-agent pairs of all rounds, equal for plans which only differ in the order of the rounds
+    std::vector<std::pair<Symbol, Symbol>> signature() const;
+
+    // Copy all nodes and edges of another plan into this graph.
+    // The root of the other plan is identified with the node `root_id` of this graph.
+    //   \return: mapping of node indexes of the other plan to indexes in this graph
+    std::unordered_map<NodeIndex, NodeIndex> insertSubplan(const AssemblyPlan&, NodeIndex root_id);
+};
+
+inline void AssemblyPlan::print(std::ostream& os) const
+{
+    int ctr = 1;
+    for (const auto& round : rounds)
+    {
+        os << " " << std::to_string(ctr++) << ". ";
+        for (const auto& assignment : round)
+        {
+            os << " [" << nameOf(assignment.action) << " - " << nameOf(assignment.agent) << "]" << "";
+        }
+        os << std::endl;
+    }
+    os << std::endl << "Cost: " << cost << std::endl << std::endl;
+}
+
+inline std::unordered_map<NodeIndex, NodeIndex>
+AssemblyPlan::insertSubplan(const AssemblyPlan& other, NodeIndex root_id)
+{
+    // The graph accessors are non-const, the copy is cheap compared to the search
+    auto source = other.graph;
+    std::unordered_map<NodeIndex, NodeIndex> idxs;
+    idxs[source.root->id] = root_id;
+
+    for (auto node : source.nodes())
+    {
+        if (node->id != source.root->id)
+            idxs[node->id] = graph.insertNode(node->data);
+    }
+    for (auto edge : source.edges())
+    {
+        graph.insertEdge(edge->data, idxs.at(edge->getSource()), idxs.at(edge->getDestination()));
+    }
+    return idxs;
+}
+
+inline double AssemblyPlan::roundCost(const config::Configuration& config) const
+{
+    double total = 0;
+    for (const auto& round : rounds)
+    {
+        if (round.empty())
+            continue;
+        double sum = 0;
+        for (const auto& assignment : round)
+            sum += config.actions.at(assignment.action).costs.at(assignment.agent);
+        total += sum / round.size();
+    }
+    return total;
+}
+
+inline std::vector<std::pair<Symbol, Symbol>> AssemblyPlan::signature() const
+{
+    std::vector<std::pair<Symbol, Symbol>> pairs;
+    for (const auto& round : rounds)
+        for (const auto& assignment : round)
+            pairs.emplace_back(assignment.action, assignment.agent);
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+}
+
+// Cheapest interaction needed to hand a subassembly to an agent which cannot reach it
+//   @subassembly: name of the subassembly
+//   @agent:       agent performing the action which consumes the subassembly
+//   \return:      interaction action and the agent performing it, or nullptr if the subassembly is reachable
+//
+inline std::pair<const config::Action*, Symbol>
+cheapestInteraction(const config::Configuration& config, Symbol subassembly, Symbol agent)
+{
+    const auto& reach = config.subassemblies.at(subassembly).reachability.at(agent);
+    if (reach.reachable)
+        return std::make_pair(nullptr, Symbol(0));
+    const auto& action = config.actions.at(reach.interaction.name);
+    auto best = std::min_element(action.costs.begin(), action.costs.end(),
+                                 [](const auto& a, const auto& b) { return a.second < b.second; });
+    return std::make_pair(&action, best->first);
+}
+
+// Every stream is a sequence of rounds which depend on their predecessors.
+// Rounds are merged front to back; an assignment whose agent is taken in the current round is
+// postponed, and a stream only advances to its next round once all assignments of the current one
+// are placed.
+inline PlanRounds mergeRounds(const std::vector<PlanRounds>& streams)
+{
+    std::vector<std::size_t> next(streams.size(), 0);
+    std::vector<std::vector<AgentActionAssignment>> current(streams.size());
+
+    PlanRounds merged;
+    while (true)
+    {
+        std::vector<AgentActionAssignment> round;
+        std::unordered_set<Symbol> busy;
+        bool work_left = false;
+
+        for (std::size_t i = 0; i < streams.size(); i++)
+        {
+            if (current[i].empty() && next[i] < streams[i].size())
+                current[i] = streams[i][next[i]++];
+
+            std::vector<AgentActionAssignment> postponed;
+            for (auto& assignment : current[i])
+            {
+                if (busy.insert(assignment.agent).second)
+                    round.push_back(assignment);
+                else
+                    postponed.push_back(assignment);
+            }
+            current[i].swap(postponed);
+            work_left |= !current[i].empty() || next[i] < streams[i].size();
+        }
+
+        if (!round.empty())
+            merged.push_back(std::move(round));
+        if (!work_left)
+            break;
+    }
+    return merged;
+}
+
+// Build the plan of a subassembly from the plans of the children of the selected action.
+// Children the agent cannot reach are handed over by their cheapest interaction, which follows
+// the child's own plan. The child plans are executed in parallel where their agents allow it.
+//   @graph:       A/O graph containing the subassembly
+//   @config:      configuration contianing the cost_map and reachability_map
+//   @id:          subassembly to plan
+//   @action:      action disassembling the subassembly
+//   @agent:       agent performing the action
+//   @child_plans: plans of the successors of the action, in the order of `successorNodes`
+//   \return:      plan rooted at the subassembly
+//
+inline AssemblyPlan composePlan(Graph<AssemblyData,EdgeData>& graph, const config::Configuration& config,
+                                NodeIndex id, NodeIndex action, Symbol agent,
+                                const std::vector<const AssemblyPlan*>& child_plans)
+{
+    AssemblyPlan plan;
+    auto& g = plan.graph;
+    auto sa_id = g.insertNode(graph.getNodeData(id));
+    g.root = g.getNode(sa_id);
+
+    auto action_data = graph.getNodeData(action);
+    action_data.assigned_agent = agent;
+    auto action_id = g.insertNode(action_data);
+    g.insertEdge(EdgeData(), sa_id, action_id);
+    plan.cost = config.actions.at(action_data.name).costs.at(agent);
+
+    std::vector<PlanRounds> streams;
+    auto children = graph.successorNodes(action);
+    for (std::size_t c = 0; c < children.size(); c++)
+    {
+        auto child = children[c];
+        const auto& child_plan = *child_plans.at(c);
+        auto child_id = g.insertNode(graph.getNodeData(child));
+        auto idxs = plan.insertSubplan(child_plan, child_id);
+        plan.cost += child_plan.cost;
+
+        PlanRounds rounds = child_plan.rounds;
+        for (auto& round : rounds)
+            for (auto& assignment : round)
+                assignment.action_node_id = idxs.at(assignment.action_node_id);
+
+        auto i = cheapestInteraction(config, graph.getNodeData(child).name, agent);
+        if (i.first)
+        {
+            AssemblyData prime_data = graph.getNodeData(child);
+            prime_data.type = NodeType::INTERASSEMBLY;
+            auto prime_id = g.insertNode(prime_data);
+
+            AssemblyData idata;
+            idata.name = i.first->name;
+            idata.type = NodeType::INTERACTION;
+            idata.assigned_agent = i.second;
+            idata.interaction_prev = action_id;
+            idata.interaction_or = prime_id;
+            idata.interaction_next = child_id;
+            auto interaction_id = g.insertNode(idata);
+
+            g.insertEdge(EdgeData(), action_id, prime_id);
+            g.insertEdge(EdgeData(), prime_id, interaction_id);
+            g.insertEdge(EdgeData(), interaction_id, child_id);
+            rounds.push_back({AgentActionAssignment{i.second, i.first->name, interaction_id}});
+            plan.cost += i.first->costs.at(i.second);
+        }
+        else
+        {
+            g.insertEdge(EdgeData(), action_id, child_id);
+        }
+        streams.push_back(std::move(rounds));
+    }
+
+    plan.rounds = mergeRounds(streams);
+    plan.rounds.push_back({AgentActionAssignment{agent, action_data.name, action_id}});
+    return plan;
+}
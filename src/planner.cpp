@@ -0,0 +1,412 @@
+#include "planner.hpp"
+
+Planner::Planner(PlannerOptions opts)
+  : options(opts)
+{}
+
+// Start planning
+//   @graph:  pointer to the original A/O graph obtained from the IoXml
+//   @config: configuration contianing the cost_map and reachability_map
+//   \return: vector containing the assembly plan
+//
+Graph<AssemblyData,EdgeData>
+Planner::operator()(Graph<AssemblyData,EdgeData> graph, config::Configuration& config)
+{
+    statistics = SearchStatistics();
+    plans.clear();
+    schedules.clear();
+
+    if ((!options.checkpoint_path.empty() || !options.resume_path.empty()) &&
+        (options.solver != SolverType::ASTAR || options.alternatives > 1 || !usesCheckpoints()))
+    {
+        std::cerr << "CHECKPOINT WARNING: Checkpoints only apply to the in-memory A* search of a single plan "
+                  << "without decomposition, partial expansion, suboptimality or a memory or open limit" << std::endl;
+    }
+
+    if (options.decompose)
+    {
+        std::size_t threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+        Decomposer decomposer(graph, config, options.decompose_threshold, threads,
+            [this](Graph<AssemblyData,EdgeData>& g, config::Configuration& c, SearchStatistics& s)
+            { return solve(g, c, s); });
+        plans.push_back(decomposer.solve(statistics));
+    }
+    else if (options.solver == SolverType::ASTAR && options.alternatives > 1)
+    {
+        plans = search(graph, config, statistics, options.alternatives);
+    }
+    else if (options.solver == SolverType::PARETO)
+    {
+        plans = searchPareto(graph, config, statistics);
+    }
+    else
+    {
+        plans.push_back(solve(graph, config, statistics));
+    }
+    status = options.control.token.status();
+
+    {
+        ScopedPhase phase(&statistics, "schedule");
+        Scheduler scheduler(config);
+        for (auto& plan : plans)
+            schedules.push_back(scheduler.schedule(plan));
+    }
+
+    for (std::size_t i = 0; options.print && i < plans.size(); i++)
+    {
+        if (plans.size() > 1)
+            std::cout << "Plan " << i + 1 << ":" << std::endl;
+        plans[i].print(std::cout);
+        schedules[i].print(std::cout);
+    }
+    return plans.front().graph;
+}
+
+bool Planner::usesCheckpoints() const
+{
+    return !options.decompose && !options.partial_expansion && options.suboptimality <= 1 &&
+           options.open_limit == 0 && options.memory_limit == 0;
+}
+
+// Plan the subassembly at the root of the graph
+//   @graph:      A/O graph, interaction nodes may be added by the solver
+//   @config:     configuration contianing the cost_map and reachability_map
+//   @statistics: receives counters and timings of the solver
+//   \return:     assembly plan rooted at the root of `graph`
+//
+AssemblyPlan Planner::solve(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                            SearchStatistics& statistics) const
+{
+    if (options.solver == SolverType::AOSTAR)
+    {
+        ScopedPhase phase(&statistics, "search");
+        AOStarSolver solver(graph, config, &statistics);
+        return solver.solve();
+    }
+    // Subproblems of the decomposition take the cheapest plan of the frontier
+    if (options.solver == SolverType::PARETO)
+        return searchPareto(graph, config, statistics).front();
+    return search(graph, config, statistics);
+}
+
+// Search the plan for the subassembly at the root of the graph
+//   @graph:      A/O graph, interaction nodes are added during the search
+//   @config:     configuration contianing the cost_map and reachability_map
+//   @statistics: receives counters and timings of the search
+//   \return:     assembly plan rooted at the root of `graph`
+//
+AssemblyPlan Planner::search(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                             SearchStatistics& statistics) const
+{
+    return search(graph, config, statistics, 1).front();
+}
+
+// Search up to `count` distinct plans for the subassembly at the root of the graph.
+// Plans are distinct if they differ in an assignment; the order of the rounds is not compared.
+// The incumbent bound would discard the alternatives, so pruning only applies to a single plan.
+//   @graph:      A/O graph, interaction nodes are added during the search
+//   @config:     configuration contianing the cost_map and reachability_map
+//   @statistics: receives counters and timings of the search
+//   @count:      maximum number of plans
+//   \return:     at least one plan, in order of the A* objective
+//
+std::vector<AssemblyPlan> Planner::search(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                                          SearchStatistics& statistics, std::size_t count) const
+{
+    // Create the search tree.
+    // It is a different structure than the graph passed as a function parameter.
+    // It stores the hypernodes used later for the A* search.
+    SearchTree search_tree;
+    SearchData root_data = rootState(graph);
+
+    // Create the NodeExpander and pass it to the AStarSearch.
+    // The AStarSearch uses the received Expander later during the search.
+    // If a different expansion-behavior is desired, just modify the exapnder,
+    // obeying to the interface used by the AStarSearch.
+    NodeExpander expander(graph, search_tree, config, &statistics);
+    root_data.minimum_cost_action = expander.minimumActionCost(root_data);
+    AStarSearch astar(graph, &statistics, detectOpenListType(config), options.partial_expansion);
+    astar.setControl(&options.control);
+    if (options.suboptimality > 1 && count <= 1)
+        astar.setFocal(options.suboptimality, expander.cheapestAction());
+    if (options.dominance && count <= 1)
+        astar.setDominance(config);
+
+    // Seed the branch-and-bound with the cheaper of the greedy and the AO* plan.
+    // Both are valid A* solutions, the search only keeps nodes which can still beat them.
+    // Alternatives may be more expensive than the incumbent, it is then only compared with them.
+    AssemblyPlan incumbent;
+    if (options.prune)
+    {
+        ScopedPhase phase(&statistics, "incumbent");
+        incumbent = incumbentPlan(graph, config);
+        if (count <= 1)
+        {
+            expander.setBound(incumbent.roundCost(config));
+            astar.setBound(incumbent.roundCost(config), expander.cheapestAction());
+        }
+    }
+
+    // Continue from a checkpoint of the same input, the tree and the interactions are only taken over
+    // once the whole file was read
+    bool checkpoints = count <= 1 && usesCheckpoints();
+    CheckpointKey key;
+    std::vector<OpenEntry> open;
+    bool resumed = false;
+    if (checkpoints)
+        key = checkpointKey(graph, config);
+    if (checkpoints && !options.resume_path.empty())
+    {
+        ScopedPhase phase(&statistics, "restore");
+        auto restored_graph = graph;
+        SearchTree restored_tree;
+        double bound;
+        resumed = readCheckpoint(options.resume_path, restored_graph, key, restored_tree, open, bound, statistics);
+        if (resumed)
+        {
+            graph = std::move(restored_graph);
+            search_tree = std::move(restored_tree);
+            expander.setBound(bound);
+            astar.setBound(bound, expander.cheapestAction());
+        }
+        else
+        {
+            std::cerr << "CHECKPOINT ERROR: Searching from the root instead" << std::endl;
+        }
+    }
+    NodeIndex root_id = resumed ? 0 : search_tree.insertRoot(std::move(root_data));
+    if (checkpoints && !options.checkpoint_path.empty())
+    {
+        astar.setCheckpoint(options.checkpoint_interval,
+            [&](const SearchTree& tree, const OpenList& open_list, double bound)
+            {
+                if (!writeCheckpoint(options.checkpoint_path, graph, key, tree, open_list, bound, statistics))
+                    std::cerr << "CHECKPOINT ERROR: Could not write " << options.checkpoint_path << std::endl;
+            });
+    }
+
+    // Run search, the goals are compared before the first backtracking inserts interaction edges
+    std::vector<NodeIndex> goals;
+    {
+        ScopedPhase phase(&statistics, "search");
+        if (options.open_limit > 0 && count <= 1)
+        {
+            ExternalAStarSearch external(graph, &statistics, options.open_limit, options.spill_directory);
+            external.setControl(&options.control);
+            if (options.prune)
+                external.setBound(incumbent.roundCost(config), expander.cheapestAction());
+            auto goal = external.search(search_tree, root_id, expander);
+            if (goal != SearchTree::none)
+                goals.push_back(goal);
+        }
+        else if (options.memory_limit > 0 && count <= 1)
+        {
+            SMAStarSearch bounded(graph, &statistics, options.memory_limit, expander.cheapestAction());
+            expander.reuseInteractions(true);
+            bounded.setControl(&options.control);
+            if (options.prune)
+                bounded.setBound(incumbent.roundCost(config));
+            auto goal = bounded.search(search_tree, root_id, expander);
+            if (goal != SearchTree::none)
+                goals.push_back(goal);
+        }
+        else
+        {
+            std::set<std::vector<std::tuple<Symbol, NodeIndex, NodeIndex, Symbol>>> signatures;
+            auto goal = resumed ? astar.restore(search_tree, open, expander)
+                                : astar.search(search_tree, root_id, expander);
+            while (goal != SearchTree::none)
+            {
+                if (signatures.insert(planSignature(graph, search_tree, goal)).second)
+                    goals.push_back(goal);
+                if (goals.size() >= count)
+                    break;
+                goal = astar.resume(search_tree, expander);
+            }
+        }
+    }
+    statistics.peak_search_bytes = search_tree.peakBytes();
+
+    // No plan of the search beats the incumbent. Without one, the search can only have been stopped,
+    // and the incumbent is constructed now as the best known plan.
+    if (goals.empty())
+    {
+        if (!options.prune)
+            incumbent = incumbentPlan(graph, config);
+        return {incumbent};
+    }
+
+    std::vector<AssemblyPlan> plans;
+    {
+        ScopedPhase phase(&statistics, "backtrack");
+        plans = backtrack(graph, config, search_tree, goals);
+    }
+
+    // The heuristic is not admissible, without the bound the incumbent may beat every searched plan
+    if (options.prune && count > 1 && incumbent.roundCost(config) < plans[0].roundCost(config))
+    {
+        auto signature = incumbent.signature();
+        plans.erase(std::remove_if(plans.begin(), plans.end(),
+                                   [&](const AssemblyPlan& p) { return p.signature() == signature; }),
+                    plans.end());
+        plans.insert(plans.begin(), std::move(incumbent));
+        if (plans.size() > count)
+            plans.pop_back();
+    }
+    return plans;
+}
+
+// Search the Pareto frontier of total action cost and makespan for the subassembly at the root of the graph
+//   @graph:      A/O graph, interaction nodes are added during the search
+//   @config:     configuration contianing the cost_map and reachability_map
+//   @statistics: receives counters and timings of the search
+//   \return:     at least one plan, in order of increasing cost and decreasing makespan
+//
+std::vector<AssemblyPlan> Planner::searchPareto(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                                                SearchStatistics& statistics) const
+{
+    SearchTree search_tree;
+    SearchData root_data = rootState(graph);
+    NodeExpander expander(graph, search_tree, config, &statistics);
+    root_data.minimum_cost_action = expander.minimumActionCost(root_data);
+    auto root_id = search_tree.insertRoot(std::move(root_data));
+
+    std::vector<NodeIndex> goals;
+    {
+        ScopedPhase phase(&statistics, "search");
+        ParetoSearch pareto(graph, config, &statistics, &options.control);
+        goals = pareto.search(search_tree, root_id, expander);
+    }
+    statistics.peak_search_bytes = search_tree.peakBytes();
+
+    // The search was stopped before the first goal
+    if (goals.empty())
+        return {incumbentPlan(graph, config)};
+
+    ScopedPhase phase(&statistics, "backtrack");
+    return backtrack(graph, config, search_tree, goals);
+}
+
+// The AO* plan minimizes the total action cost and thereby avoids infeasible assignments
+AssemblyPlan Planner::incumbentPlan(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config)
+{
+    auto incumbent = GreedyPlanner(graph, config).solve();
+    auto exact = AOStarSolver(graph, config).solve();
+    if (exact.roundCost(config) < incumbent.roundCost(config))
+        return exact;
+    return incumbent;
+}
+
+// Set the subassemblies and actions of the first supernode.
+// The actions correspond to all possible moves we can take in the first supernode.
+SearchData Planner::rootState(Graph<AssemblyData,EdgeData>& graph)
+{
+    SearchData root_data;
+    root_data.subassemblies.set(graph.root->data.name, graph.root->id);
+    root_data.hash = graph.root->data.key;
+    for (auto &x : graph.getSuccessorNodes(graph.root->id))
+    {
+        root_data.actions.set(x->data.name, x->id);
+        root_data.hash ^= x->data.key;
+    }
+    return root_data;
+}
+
+// Every plan selects its own interactions, so the plans after the first one are backtracked in copies
+// which are taken before the first plan connects its interactions in the passed graph
+std::vector<AssemblyPlan> Planner::backtrack(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                                             SearchTree& search_tree, const std::vector<NodeIndex>& goals)
+{
+    TRACE_SCOPE("Planner::backtrack");
+
+    std::vector<AssemblyPlan> plans(goals.size());
+    for (std::size_t i = goals.size() - 1; i > 0; i--)
+    {
+        auto copy = graph;
+        plans[i] = backtrack(copy, config, search_tree, goals[i]);
+    }
+    plans[0] = backtrack(graph, config, search_tree, goals[0]);
+    return plans;
+}
+
+// Backtrack the plan of a goal:
+//   @graph:  A/O graph the search was run on, the selected interactions are connected in it
+//   @config: configuration contianing the cost_map and reachability_map
+//   @tree:   search tree containing the goal
+//   @result: goal node of the search
+//   \return: assembly plan rooted at the root of `graph`
+//
+AssemblyPlan Planner::backtrack(Graph<AssemblyData,EdgeData>& graph, config::Configuration& config,
+                                SearchTree& search_tree, NodeIndex result)
+{
+    // Track the retrieved optimal assebly sequence
+    AssemblyPlan plan;
+    auto& assembly_plan = plan.graph;
+
+    // Track mapping of indexes between graph used for search and the final plan 
+    std::unordered_map<NodeIndex, NodeIndex> idxs;
+
+    // Backtrack the optimal solution using the parent pointers of the search tree
+    // Based on the optimal assignments, construct the final assembly plan
+    while (search_tree.hasParent(result))
+    {
+        std::vector<AgentActionAssignment> round;
+
+        // Go over all assignements that are part of given state in the search graph
+        for (auto &assignment : search_tree.assignment(result).planned_assignments)
+        {
+            auto action_data = graph.getNodeData(assignment.action_node_id);
+            action_data.assigned_agent = assignment.agent;
+
+            // If an interaction is found in the optimal assignment, its predecessor must be connected to it
+            // This is necessary, as potential interaction are inserted into the input graph during the search,
+            // and referenced by the supernodes of the search graph. 
+            // Full reachability to a gieven interaction is only established when it is selected as part of the solution. 
+            if(action_data.type == NodeType::INTERACTION)
+            {
+                auto x = graph.getNode(assignment.action_node_id);
+                graph.eraseEdge(x->data.interaction_prev, x->data.interaction_next);
+                graph.insertEdge(EdgeData(), x->data.interaction_prev, x->data.interaction_or);
+            }
+
+            // Insert nodes that contribute to the optimum solution to the assembly plan graph
+            // Action node
+            auto action_id = assembly_plan.insertNode(action_data);
+            // Predecessor subassemblies of the given action
+            for(auto &x: graph.getPredecessorNodes(assignment.action_node_id))
+            {
+                if(!idxs.count(x->id))
+                {
+                    auto prime_id = assembly_plan.insertNode(x->data);
+                    idxs.insert(std::make_pair(x->id, prime_id));
+                }
+                assembly_plan.insertEdge(EdgeData(), idxs.at(x->id), action_id);
+            }
+            // Successor subassemblies of the given action
+            for(auto &x: graph.getSuccessorNodes(assignment.action_node_id))
+            {
+                if(!idxs.count(x->id))
+                {
+                    auto prime_id = assembly_plan.insertNode(x->data);
+                    idxs.insert(std::make_pair(x->id, prime_id));
+                }
+                assembly_plan.insertEdge(EdgeData(), action_id, idxs.at(x->id));
+            }
+
+            double cur_cost = config.actions[assignment.action].costs[assignment.agent];
+            plan.cost += cur_cost;
+
+            round.push_back(assignment);
+            round.back().action_node_id = action_id;
+        }
+        plan.rounds.push_back(std::move(round));
+        result = search_tree.node(result).parent;
+    }
+
+    // The root has no predecessor action if it cannot be disassembled at all
+    if (!idxs.count(graph.root->id))
+        idxs[graph.root->id] = assembly_plan.insertNode(graph.root->data);
+    assembly_plan.root = assembly_plan.getNode(idxs.at(graph.root->id));
+
+    return plan;
+}
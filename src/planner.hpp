@@ -1,122 +1,153 @@
 #pragma once
 
 #include <iostream>
+#include <set>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include "dotwriter.hpp"
+#include "aostar.hpp"
+#include "control.hpp"
 #include "astar.hpp"
+#include "checkpoint.hpp"
+#include "decomposer.hpp"
+#include "external_astar.hpp"
+#include "greedy.hpp"
+#include "pareto.hpp"
+#include "plan.hpp"
+#include "progress.hpp"
+#include "scheduler.hpp"
+#include "search_tree.hpp"
+#include "smastar.hpp"
+#include "statistics.hpp"
+#include "trace.hpp"
+
+// Algorithm used to plan an assembly (or a subassembly of the decomposition)
+enum class SolverType
+{
+    // A* over hypernodes, minimizes the sum of the mean action cost per round
+    ASTAR,
+    // Dynamic programming over the A/O graph, minimizes the total action cost
+    AOSTAR,
+    // Multi-objective search, returns the plans on the Pareto frontier of total cost and makespan
+    PARETO
+};
+
+// Options selecting how the planner solves the problem
+struct PlannerOptions
+{
+    SolverType solver = SolverType::ASTAR;
+    // Discard hypernodes of the A* search which cannot improve on a greedily constructed plan
+    bool prune = true;
+    // Accept plans costing up to this factor more than the optimum, searched by the focal search of
+    // `AStarSearch` instead of A*. 1 searches the optimal plan. Does not apply to alternatives.
+    double suboptimality = 1;
+    // Discard hypernodes of the A* search whose open subassemblies include those of an expanded hypernode
+    // which is not more expensive, see `DominanceIndex`. Only applies to the in-memory search of a single plan.
+    bool dominance = false;
+    // Generate the children of a hypernode lazily in cost order instead of enumerating all assignments
+    bool partial_expansion = false;
+    // Split the assembly into independent subassemblies which are solved in parallel
+    bool decompose = false;
+    // Subassemblies with at most this many actions below them are searched as a whole
+    std::size_t decompose_threshold = 12;
+    // Worker threads used by the decomposition, 0 selects the number of hardware threads
+    std::size_t threads = 0;
+    // Number of distinct plans returned by the A* search, the best one first.
+    // Alternatives are searched without the incumbent bound and without decomposition.
+    std::size_t alternatives = 1;
+    // Hypernodes of the A* open list kept in memory, the others are written to run files.
+    // 0 keeps the whole open list in memory. Only applies to the search of a single plan.
+    std::size_t open_limit = 0;
+    // Directory of the run files, the system temporary directory if empty
+    std::string spill_directory;
+    // Memory budget in bytes of the search of a single plan, which is then performed by SMA* and returns the
+    // optimal plan whose path fits into it. 0 leaves the memory unbounded.
+    std::size_t memory_limit = 0;
+    // File the A* search writes its checkpoints to, none if empty.
+    // Only applies to the in-memory search of a single plan without decomposition and partial expansion.
+    std::string checkpoint_path;
+    // Minimum time between two checkpoints
+    std::chrono::milliseconds checkpoint_interval{300000};
+    // Checkpoint the A* search continues from instead of its root, written for the same graph and configuration
+    std::string resume_path;
+    // Cancellation, deadline and progress callback of the searches
+    PlanningControl control;
+    // Print the rounds and the schedule of every plan to stdout
+    bool print = true;
+};
 
 // Planner - used as a top-level supervisor for the planning process
 struct Planner
 {
     Planner() = default;
     Planner(const Planner&) = default;
+    Planner(PlannerOptions);
     // Start Planning
     Graph<AssemblyData,EdgeData> operator()(Graph<AssemblyData,EdgeData>, config::Configuration& );
+
+    // Run the A* search from the root of the given graph and backtrack the optimal plan.
+    // Interactions selected by the search are inserted into the passed graph.
+    AssemblyPlan search(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchStatistics&) const;
+
+    // Continue the A* search past the first goal until `count` distinct plans are found, best first.
+    // The first plan is backtracked in the passed graph, the others in copies of it.
+    std::vector<AssemblyPlan> search(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchStatistics&,
+                                     std::size_t count) const;
+
+    // Search the plans on the Pareto frontier of total action cost and makespan, cheapest first
+    std::vector<AssemblyPlan> searchPareto(Graph<AssemblyData,EdgeData>&, config::Configuration&,
+                                           SearchStatistics&) const;
+
+    // Plan the root of the given graph with the solver selected in the options
+    AssemblyPlan solve(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchStatistics&) const;
+
+    PlannerOptions options;
+
+    // Counters and phase timings of the last call to `operator()`
+    SearchStatistics statistics;
+    // Whether the last call to `operator()` searched to completion or returned the best plan known when stopped
+    PlanningStatus status = PlanningStatus::COMPLETE;
+
+    // Plans found by the last call to `operator()`, best first. The graph of the first one is returned.
+    std::vector<AssemblyPlan> plans;
+    // Timed execution of every plan in `plans`, see `Scheduler`
+    std::vector<Schedule> schedules;
+
+  private:
+    friend class Replanner;
+
+    // Whether the A* search of a single plan writes and restores checkpoints, see `PlannerOptions`
+    bool usesCheckpoints() const;
+    // Cheaper of the greedy and the AO* plan, the incumbent of the pruning and the best known plan
+    // when a search is stopped before its first goal
+    static AssemblyPlan incumbentPlan(Graph<AssemblyData,EdgeData>&, config::Configuration&);
+    // State of the first hypernode: the root of the graph with its actions
+    static SearchData rootState(Graph<AssemblyData,EdgeData>&);
+    // Build the plan of the path from the root of the search tree to the given goal
+    static AssemblyPlan backtrack(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchTree&, NodeIndex);
+    // Build the plans of several goals, the first one in the passed graph and the others in copies of it
+    static std::vector<AssemblyPlan> backtrack(Graph<AssemblyData,EdgeData>&, config::Configuration&, SearchTree&,
+                                               const std::vector<NodeIndex>&);
 };
 
-// Start planning
-//   @graph:  pointer to the original A/O graph obtained from the IoXml
-//   @config: configuration contianing the cost_map and reachability_map
-//   \return: vector containing the assembly plan
-//
-Graph<AssemblyData,EdgeData>
-Planner::operator()(Graph<AssemblyData,EdgeData> graph, config::Configuration& config)
+// Assignments of the path to a goal, independent of the order of the rounds.
+// Interactions are created anew for every expansion, they are identified by the nodes they connect.
+inline std::vector<std::tuple<Symbol, NodeIndex, NodeIndex, Symbol>>
+planSignature(Graph<AssemblyData,EdgeData>& graph, SearchTree& tree, NodeIndex goal)
 {
-    // Create a new Graph.
-    // It is a different graph the the one passed as a function parameter.
-    // This one is the graph of hypernodes used later for the A* search.
-    Graph<SearchData,EdgeData> search_graph;
-    auto new_root_id = search_graph.insertNode(SearchData());
-    Node<SearchData> *new_root = search_graph.getNode(new_root_id);
-
-    // Set the subassemblies and actions of the first supernode.
-    // The actions correspond to all possible moves we can take in the first supernode.
-    new_root->data.subassemblies[graph.root->data.name] = graph.root->id;
-    for (auto &x : graph.getSuccessorNodes(graph.root->id))
+    std::vector<std::tuple<Symbol, NodeIndex, NodeIndex, Symbol>> signature;
+    for (; tree.hasParent(goal); goal = tree.node(goal).parent)
     {
-        new_root->data.actions[x->data.name] = x->id;
-    }
-
-    // Create the NodeExpander and pass it to the AStarSearch.
-    // The AStarSearch uses the received Expander later during the search.
-    // If a different expansion-behavior is desired, just modify the exapnder,
-    // obeying to the interface used by the AStarSearch.
-    NodeExpander expander(graph, search_graph, config);
-
-    // Run search
-    AStarSearch astar(graph);
-    Node<SearchData> *result = astar.search(search_graph, new_root, expander);
-
-    // Track the retrieved optimal assebly sequence
-    Graph<AssemblyData,EdgeData> assembly_plan;
-    
-    // Count the number of rounds in the final schedule
-    int ctr = 1;
-    double cost = 0;
-
-    // Track mapping of indexes between graph used for search and the final plan 
-    std::unordered_map<NodeIndex, NodeIndex> idxs;
-
-    // Backtrack the optimal solution using the search graph
-    // Based on the optimal assignments, construct the final assembly plan
-    while (search_graph.hasPredecessor(result->id))
-    {
-        std::cout << " " << std::to_string(ctr) << ". ";
-
-        // Go over all assignements that are part of given state in the search graph
-        for (auto &assignment : search_graph.getPredecessorEdges(result->id).front()->data.planned_assignments)
+        for (const auto& assignment : tree.assignment(goal).planned_assignments)
         {
-            std::cout << " [" << assignment.action << " - " << assignment.agent << "]" << "";
-            
-            auto action_data = graph.getNodeData(assignment.action_node_id);
-            action_data.assigned_agent = assignment.agent;
-
-            // If an interaction is found in the optimal assignment, its predecessor must be connected to it
-            // This is necessary, as potential interaction are inserted into the input graph during the search,
-            // and referenced by the supernodes of the search graph. 
-            // Full reachability to a gieven interaction is only established when it is selected as part of the solution. 
-            if(action_data.type == NodeType::INTERACTION)
-            {
-                auto x = graph.getNode(assignment.action_node_id);
-                graph.eraseEdge(x->data.interaction_prev, x->data.interaction_next);
-                graph.insertEdge(EdgeData(), x->data.interaction_prev, x->data.interaction_or);
-            }
-
-            // Insert nodes that contribute to the optimum solution to the assembly plan graph
-            // Action node
-            auto action_id = assembly_plan.insertNode(action_data);
-            // Predecessor subassemblies of the given action
-            for(auto &x: graph.getPredecessorNodes(assignment.action_node_id))
-            {
-                if(!idxs.count(x->id))
-                {
-                    auto prime_id = assembly_plan.insertNode(x->data);
-                    idxs.insert(std::make_pair(x->id, prime_id));
-                }
-                assembly_plan.insertEdge(EdgeData(), idxs.at(x->id), action_id);
-            }
-            // Successor subassemblies of the given action
-            for(auto &x: graph.getSuccessorNodes(assignment.action_node_id))
-            {
-                if(!idxs.count(x->id))
-                {
-                    auto prime_id = assembly_plan.insertNode(x->data);
-                    idxs.insert(std::make_pair(x->id, prime_id));
-                }
-                assembly_plan.insertEdge(EdgeData(), action_id, idxs.at(x->id));
-            }
-
-            double cur_cost = config.actions[assignment.action].costs[assignment.agent];
-            cost += cur_cost;
+            const auto& data = graph.getNodeData(assignment.action_node_id);
+            if (data.type == NodeType::INTERACTION)
+                signature.emplace_back(data.name, data.interaction_prev, data.interaction_next, assignment.agent);
+            else
+                signature.emplace_back(data.name, assignment.action_node_id, 0, assignment.agent);
         }
-        ctr++;
-        std::cout << std::endl;
-        result = search_graph.getPredecessorNodes(result->id).front();
     }
-
-    assembly_plan.root = assembly_plan.getNode(idxs[graph.root->id]);
-
-    std::cout << std::endl << "Cost: " << cost << std::endl << std::endl;
-
-    return assembly_plan;
+    std::sort(signature.begin(), signature.end());
+    return signature;
 }
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "progress.hpp"
+
+// Atomic parts contained in a subassembly, sorted
+static const std::vector<NodeIndex>&
+partsOf(Graph<AssemblyData,EdgeData>& graph, NodeIndex id, std::unordered_map<NodeIndex, std::vector<NodeIndex>>& memo)
+{
+    auto it = memo.find(id);
+    if (it != memo.end())
+        return it->second;
+
+    std::vector<NodeIndex> parts;
+    if (!graph.hasSuccessor(id))
+        parts.push_back(id);
+    for (auto action : graph.successorNodes(id))
+    {
+        for (auto child : graph.successorNodes(action))
+        {
+            const auto& child_parts = partsOf(graph, child, memo);
+            parts.insert(parts.end(), child_parts.begin(), child_parts.end());
+        }
+    }
+    std::sort(parts.begin(), parts.end());
+    parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+    return memo[id] = std::move(parts);
+}
+
+bool applyProgress(Graph<AssemblyData,EdgeData>& graph, const ExecutionProgress& progress)
+{
+    std::unordered_map<Symbol, NodeIndex> ids;
+    for (auto node : graph.nodes())
+    {
+        if (node->data.type == NodeType::SUBASSEMBLY || node->data.type == NodeType::ACTION)
+            ids[node->data.name] = node->id;
+    }
+
+    std::vector<NodeIndex> done;
+    for (const auto& name : progress.completed)
+    {
+        auto it = ids.find(name);
+        if (it == ids.end() || graph.getNodeData(it->second).type != NodeType::SUBASSEMBLY)
+        {
+            std::cerr << "PROGRESS ERROR: Unknown subassembly " << nameOf(name) << std::endl;
+            return false;
+        }
+        done.push_back(it->second);
+    }
+    for (const auto& name : progress.running)
+    {
+        auto it = ids.find(name);
+        if (it == ids.end() || graph.getNodeData(it->second).type != NodeType::ACTION)
+        {
+            std::cerr << "PROGRESS ERROR: Unknown action " << nameOf(name) << std::endl;
+            return false;
+        }
+        auto producer = graph.predecessorNodes(it->second);
+        if (producer.empty())
+        {
+            std::cerr << "PROGRESS ERROR: Action " << nameOf(name) << " does not disassemble a subassembly" << std::endl;
+            return false;
+        }
+        done.push_back(producer.front());
+    }
+
+    // Parts are taken from the complete graph, before any action is removed
+    std::unordered_map<NodeIndex, std::vector<NodeIndex>> parts;
+    for (auto node : graph.nodes())
+    {
+        if (node->data.type == NodeType::SUBASSEMBLY)
+            partsOf(graph, node->id, parts);
+    }
+
+    // Subassemblies inside another completed one were consumed by it
+    auto contains = [&](NodeIndex outer, NodeIndex inner)
+    {
+        return std::includes(parts[outer].begin(), parts[outer].end(), parts[inner].begin(), parts[inner].end());
+    };
+    auto overlaps = [&](NodeIndex a, NodeIndex b)
+    {
+        const auto& pa = parts[a];
+        const auto& pb = parts[b];
+        for (auto i = pa.begin(), j = pb.begin(); i != pa.end() && j != pb.end();)
+        {
+            if (*i == *j)
+                return true;
+            *i < *j ? ++i : ++j;
+        }
+        return false;
+    };
+    std::vector<NodeIndex> frontier;
+    for (auto x : done)
+    {
+        bool inside = false;
+        for (auto y : done)
+        {
+            if (x == y)
+                continue;
+            if (contains(y, x) && !(contains(x, y) && x < y))
+                inside = true;
+            else if (overlaps(x, y) && !contains(x, y))
+            {
+                std::cerr << "PROGRESS ERROR: Completed subassemblies " << nameOf(graph.getNodeData(x).name)
+                          << " and " << nameOf(graph.getNodeData(y).name) << " share parts" << std::endl;
+                return false;
+            }
+        }
+        if (!inside && std::find(frontier.begin(), frontier.end(), x) == frontier.end())
+            frontier.push_back(x);
+    }
+
+    // Subassemblies which cannot be part of the remaining plan
+    std::vector<NodeIndex> dead;
+    for (const auto& p : parts)
+    {
+        for (auto x : frontier)
+        {
+            if (p.first != x && overlaps(p.first, x) && !contains(p.first, x))
+            {
+                dead.push_back(p.first);
+                break;
+            }
+        }
+    }
+
+    // Completed subassemblies are not disassembled any further
+    for (auto x : frontier)
+    {
+        for (auto action : graph.successorNodes(x))
+            graph.eraseEdge(x, action);
+    }
+
+    // Remove the actions producing dead subassemblies. A subassembly losing its last action is dead as well,
+    // unless it is completed; the search would otherwise take it for an atomic part.
+    std::unordered_set<NodeIndex> removed(dead.begin(), dead.end());
+    while (!dead.empty())
+    {
+        auto id = dead.back();
+        dead.pop_back();
+        for (auto action : graph.predecessorNodes(id))
+        {
+            for (auto parent : graph.predecessorNodes(action))
+            {
+                graph.eraseEdge(parent, action);
+                if (!graph.hasSuccessor(parent) && !removed.count(parent) &&
+                    std::find(frontier.begin(), frontier.end(), parent) == frontier.end())
+                {
+                    removed.insert(parent);
+                    dead.push_back(parent);
+                }
+            }
+        }
+    }
+
+    if (removed.count(graph.root->id))
+    {
+        std::cerr << "PROGRESS ERROR: The remaining parts cannot be assembled into "
+                  << nameOf(graph.root->data.name) << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+#include "graph.hpp"
+#include "types.hpp"
+
+// Progress of a partially executed plan
+struct ExecutionProgress
+{
+    // Subassemblies which are already assembled
+    std::vector<Symbol> completed;
+    // Actions which are being executed, the subassemblies they assemble count as completed.
+    // Running actions are treated as finished: their agents are available from the first round.
+    std::vector<Symbol> running;
+};
+
+// Restrict the A/O graph to the work which remains after the given progress.
+// Completed subassemblies become leaves of the graph. A subassembly which contains only some of the parts
+// of a completed one could only be built by taking it apart again, so the actions producing it are removed,
+// as are actions producing subassemblies that cannot be disassembled any more. Every solver then plans
+// the remaining actions from the root down to the completed subassemblies.
+//   @graph:    A/O graph without interactions, modified in place
+//   @progress: completed subassemblies and running actions
+// The remaining plan starts once the running actions are finished, the agents executing them are not
+// kept busy in its first rounds.
+//   \return:   false if a name is unknown, the progress is contradictory, or the root cannot be completed
+//
+bool applyProgress(Graph<AssemblyData,EdgeData>&, const ExecutionProgress&);
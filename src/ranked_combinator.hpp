@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "types.hpp"
+
+// Produces the agent-action assignments of a hypernode lazily, in order of increasing mean action cost.
+// The `Combinator` enumerates every assignment up front; here only as many as requested are computed.
+//
+// An assignment selects k distinct agents and k distinct subassemblies, and one action of every
+// selected subassembly. For a fixed k the mean cost is ordered like the sum, so the cheapest
+// assignment is a k-cardinality assignment problem, solved with the Hungarian method in its
+// successive-shortest-path form. The following assignments are ranked with Murty's method: the
+// solution space left after an assignment is partitioned into subproblems which force a prefix of
+// its (agent, subassembly, action) triples and forbid the next one. The subproblems of all k share
+// one queue ordered by the mean cost of their optimum.
+class RankedCombinator
+{
+  public:
+    RankedCombinator(Graph<AssemblyData, EdgeData> &, config::Configuration &, const std::vector<NodeIndex> &);
+
+    // Mean action cost of the next assignment, INFINITY once all assignments were produced
+    double peek() const;
+
+    // Remove and return the next assignment
+    std::vector<AgentActionAssignment> next();
+
+  private:
+    // Agent, subassembly and action index of a single agent-action pair
+    struct Triple
+    {
+        std::size_t agent;
+        std::size_t subassembly;
+        std::size_t action;
+
+        bool operator==(const Triple &o) const
+        {
+            return agent == o.agent && subassembly == o.subassembly && action == o.action;
+        }
+    };
+
+    struct Subproblem
+    {
+        // Number of agent-action pairs of the assignment
+        std::size_t k = 0;
+        std::vector<Triple> forced;
+        std::vector<Triple> forbidden;
+        // Optimum of the subproblem, containing the forced triples first
+        std::vector<Triple> solution;
+        double cost = 0;
+        // Creation order, breaks ties deterministically
+        std::size_t order = 0;
+
+        double mean() const { return cost / k; }
+    };
+
+    struct Later
+    {
+        bool operator()(const Subproblem &a, const Subproblem &b) const
+        {
+            if (a.mean() != b.mean())
+                return a.mean() > b.mean();
+            return a.order > b.order;
+        }
+    };
+
+    // Compute the optimum of a subproblem, false if it has no solution
+    bool solve(Subproblem &) const;
+    void push(Subproblem);
+
+    std::vector<Symbol> agents_;
+    std::vector<std::vector<NodeIndex>> action_ids_;
+    std::vector<std::vector<Symbol>> action_names_;
+    // Cost of [agent][subassembly][action]
+    std::vector<std::vector<std::vector<double>>> costs_;
+
+    std::priority_queue<Subproblem, std::vector<Subproblem>, Later> queue_;
+    std::size_t created_ = 0;
+};
+
+inline RankedCombinator::RankedCombinator(Graph<AssemblyData, EdgeData> &graph, config::Configuration &config,
+                                          const std::vector<NodeIndex> &nodes)
+{
+    for (auto &key_value : config.agents)
+        agents_.push_back(key_value.second.name);
+
+    for (auto node : nodes)
+    {
+        action_ids_.push_back(graph.successorNodes(node));
+        action_names_.emplace_back();
+        for (auto action_id : action_ids_.back())
+            action_names_.back().push_back(graph.getNodeData(action_id).name);
+    }
+
+    costs_.resize(agents_.size());
+    for (std::size_t g = 0; g < agents_.size(); g++)
+    {
+        for (const auto &names : action_names_)
+        {
+            costs_[g].emplace_back();
+            for (const auto &name : names)
+                costs_[g].back().push_back(config.actions[name].costs[agents_[g]]);
+        }
+    }
+
+    std::size_t l = std::min(nodes.size(), agents_.size());
+    for (std::size_t k = 1; k <= l; k++)
+    {
+        Subproblem root;
+        root.k = k;
+        push(std::move(root));
+    }
+}
+
+inline double RankedCombinator::peek() const
+{
+    return queue_.empty() ? INFINITY : queue_.top().mean();
+}
+
+inline std::vector<AgentActionAssignment> RankedCombinator::next()
+{
+    Subproblem current = queue_.top();
+    queue_.pop();
+
+    // Partition the remaining solutions of the subproblem (Murty)
+    Subproblem child;
+    child.k = current.k;
+    child.forced = current.forced;
+    child.forbidden = current.forbidden;
+    for (std::size_t i = current.forced.size(); i < current.solution.size(); i++)
+    {
+        child.forbidden.push_back(current.solution[i]);
+        push(child);
+        child.forbidden.pop_back();
+        child.forced.push_back(current.solution[i]);
+    }
+
+    // Agents in configuration order, like the assignments of the `Combinator`
+    std::sort(current.solution.begin(), current.solution.end(),
+              [](const Triple &a, const Triple &b) { return a.agent < b.agent; });
+    std::vector<AgentActionAssignment> assignment;
+    for (const auto &t : current.solution)
+    {
+        assignment.push_back(AgentActionAssignment{
+            .agent = agents_[t.agent],
+            .action = action_names_[t.subassembly][t.action],
+            .action_node_id = action_ids_[t.subassembly][t.action]
+        });
+    }
+    return assignment;
+}
+
+inline void RankedCombinator::push(Subproblem subproblem)
+{
+    if (!solve(subproblem))
+        return;
+    subproblem.order = created_++;
+    queue_.push(std::move(subproblem));
+}
+
+inline bool RankedCombinator::solve(Subproblem &sp) const
+{
+    const std::size_t m = agents_.size();
+    const std::size_t n = action_ids_.size();
+    const std::size_t none = SIZE_MAX;
+
+    sp.solution = sp.forced;
+    sp.cost = 0;
+    std::vector<bool> agent_used(m, false), subassembly_used(n, false);
+    for (const auto &t : sp.forced)
+    {
+        agent_used[t.agent] = subassembly_used[t.subassembly] = true;
+        sp.cost += costs_[t.agent][t.subassembly][t.action];
+    }
+
+    // Cheapest action which is not forbidden for every free agent-subassembly pair
+    std::vector<std::vector<double>> weight(m, std::vector<double>(n, INFINITY));
+    std::vector<std::vector<std::size_t>> choice(m, std::vector<std::size_t>(n, none));
+    for (std::size_t g = 0; g < m; g++)
+    {
+        for (std::size_t j = 0; j < n && !agent_used[g]; j++)
+        {
+            if (subassembly_used[j])
+                continue;
+            for (std::size_t a = 0; a < costs_[g][j].size(); a++)
+            {
+                if (costs_[g][j][a] < weight[g][j] &&
+                    std::find(sp.forbidden.begin(), sp.forbidden.end(), Triple{g, j, a}) == sp.forbidden.end())
+                {
+                    weight[g][j] = costs_[g][j][a];
+                    choice[g][j] = a;
+                }
+            }
+        }
+    }
+
+    // Successive shortest augmenting paths: after every augmentation the matching is the cheapest
+    // one of its size. Distances are computed with Bellman-Ford, the matrices are small.
+    std::vector<std::size_t> row_match(m, none), col_match(n, none);
+    for (std::size_t unit = sp.forced.size(); unit < sp.k; unit++)
+    {
+        std::vector<double> row_dist(m, INFINITY), col_dist(n, INFINITY);
+        std::vector<std::size_t> col_pred(n, none);
+        for (std::size_t g = 0; g < m; g++)
+        {
+            if (!agent_used[g] && row_match[g] == none)
+                row_dist[g] = 0;
+        }
+
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (std::size_t g = 0; g < m; g++)
+            {
+                if (std::isinf(row_dist[g]))
+                    continue;
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    if (std::isinf(weight[g][j]) || row_match[g] == j)
+                        continue;
+                    double d = row_dist[g] + weight[g][j];
+                    if (d < col_dist[j])
+                    {
+                        col_dist[j] = d;
+                        col_pred[j] = g;
+                        changed = true;
+                    }
+                }
+            }
+            for (std::size_t j = 0; j < n; j++)
+            {
+                auto g = col_match[j];
+                if (g == none || std::isinf(col_dist[j]))
+                    continue;
+                double d = col_dist[j] - weight[g][j];
+                if (d < row_dist[g])
+                {
+                    row_dist[g] = d;
+                    changed = true;
+                }
+            }
+        }
+
+        std::size_t target = none;
+        for (std::size_t j = 0; j < n; j++)
+        {
+            if (col_match[j] == none && !std::isinf(col_dist[j]) &&
+                (target == none || col_dist[j] < col_dist[target]))
+                target = j;
+        }
+        if (target == none)
+            return false;
+
+        // Flip the matching along the path
+        for (std::size_t j = target; j != none;)
+        {
+            auto g = col_pred[j];
+            auto previous = row_match[g];
+            row_match[g] = j;
+            col_match[j] = g;
+            j = previous;
+        }
+    }
+
+    for (std::size_t g = 0; g < m; g++)
+    {
+        if (row_match[g] == none)
+            continue;
+        auto j = row_match[g];
+        sp.solution.push_back(Triple{g, j, choice[g][j]});
+        sp.cost += weight[g][j];
+    }
+    return true;
+}
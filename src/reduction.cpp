@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
+#include "reduction.hpp"
+
+std::ostream &operator<<(std::ostream &os, const GraphReduction &r)
+{
+    os << "Reduced the graph by " << r.nodes << " nodes and " << r.edges << " edges ("
+       << r.dominated << " dominated actions, " << r.unreachable << " unreachable nodes, "
+       << r.forced << " forced subassemblies)";
+    return os;
+}
+
+// Cost of an action for an agent, missing costs count as 0 like in the expander
+static double costOf(const config::Configuration& config, Symbol action, Symbol agent)
+{
+    auto it = config.actions.find(action);
+    if (it == config.actions.end())
+        return 0;
+    auto cost = it->second.costs.find(agent);
+    return cost == it->second.costs.end() ? 0 : cost->second;
+}
+
+// Whether action `a` is at most as expensive as `b` for every agent and cheaper for one,
+// equal actions are ordered by id
+static bool dominates(Graph<AssemblyData,EdgeData>& graph, const config::Configuration& config,
+                      NodeIndex a, NodeIndex b)
+{
+    auto name_a = graph.getNodeData(a).name;
+    auto name_b = graph.getNodeData(b).name;
+    bool cheaper = false;
+    for (const auto& agent : config.agents)
+    {
+        double cost_a = costOf(config, name_a, agent.first);
+        double cost_b = costOf(config, name_b, agent.first);
+        if (cost_a > cost_b)
+            return false;
+        cheaper |= cost_a < cost_b;
+    }
+    return cheaper || a < b;
+}
+
+GraphReduction reduceGraph(Graph<AssemblyData,EdgeData>& graph, const config::Configuration& config)
+{
+    GraphReduction reduction;
+    auto nodes = graph.numberOfNodes();
+    auto edges = graph.numberOfEdges();
+
+    // Alternatives of a subassembly, grouped by their children. Dominance is a strict order,
+    // so every group keeps the actions which are not dominated by any other one.
+    std::vector<NodeIndex> dominated;
+    for (auto node : graph.nodes())
+    {
+        if (node->data.type != NodeType::SUBASSEMBLY)
+            continue;
+        std::map<std::vector<NodeIndex>, std::vector<NodeIndex>> groups;
+        for (auto action : graph.successorNodes(node->id))
+        {
+            auto children = graph.successorNodes(action);
+            std::sort(children.begin(), children.end());
+            groups[children].push_back(action);
+        }
+        for (const auto& group : groups)
+        {
+            for (auto a : group.second)
+            {
+                for (auto b : group.second)
+                {
+                    if (a != b && dominates(graph, config, b, a))
+                    {
+                        dominated.push_back(a);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    for (auto action : dominated)
+        graph.eraseNode(action);
+    reduction.dominated = dominated.size();
+
+    if (graph.root)
+    {
+        std::unordered_set<NodeIndex> reached{graph.root->id};
+        std::vector<NodeIndex> stack{graph.root->id};
+        while (!stack.empty())
+        {
+            auto id = stack.back();
+            stack.pop_back();
+            for (auto next : graph.successorNodes(id))
+            {
+                if (reached.insert(next).second)
+                    stack.push_back(next);
+            }
+        }
+        std::vector<NodeIndex> unreachable;
+        for (auto node : graph.nodes())
+        {
+            if (!reached.count(node->id))
+                unreachable.push_back(node->id);
+        }
+        for (auto id : unreachable)
+            graph.eraseNode(id);
+        reduction.unreachable = unreachable.size();
+    }
+
+    for (auto node : graph.nodes())
+    {
+        if (node->data.type == NodeType::SUBASSEMBLY && graph.numberOfSuccessors(node->id) == 1)
+            reduction.forced++;
+    }
+
+    reduction.nodes = nodes - graph.numberOfNodes();
+    reduction.edges = edges - graph.numberOfEdges();
+    return reduction;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+#include "graph.hpp"
+#include "types.hpp"
+
+// Nodes and edges removed from the A/O graph by `reduceGraph`
+struct GraphReduction
+{
+    std::size_t nodes = 0;
+    std::size_t edges = 0;
+    // Actions removed in favour of a cheaper alternative
+    std::size_t dominated = 0;
+    // Subassemblies and actions which are not part of any plan for the root
+    std::size_t unreachable = 0;
+    // Subassemblies left with a single action
+    std::size_t forced = 0;
+};
+
+std::ostream &operator<<(std::ostream &, const GraphReduction &);
+
+// Shrink the A/O graph before planning, without changing the cost of the optimal plan.
+// An action is dominated by another action of the same subassembly with the same children if it costs at
+// least as much for every agent, missing costs counting as 0; of equal actions the one added first is kept.
+// The children hand over the same subassemblies, so both actions need the same interactions, and replacing
+// the dominated action in a plan changes no round except for lowering its cost. Nodes which cannot be
+// reached from the root any more are removed afterwards.
+// Subassemblies with a single action are only counted: each action is a round of its own, and merging a
+// chain of them would change the average cost of the rounds they share with other agents.
+// The reduction holds for the given costs, a graph planned again with other costs must be read again.
+//   @graph:  A/O graph without interactions, modified in place
+//   @config: costs of the actions
+//
+GraphReduction reduceGraph(Graph<AssemblyData,EdgeData>&, const config::Configuration&);
@@ -0,0 +1,158 @@
+#include "replanner.hpp"
+
+void ConfigurationDelta::apply(config::Configuration& config) const
+{
+    for (const auto& c : costs)
+        config.actions[c.action].costs[c.agent] = c.cost;
+    for (const auto& r : reachability)
+    {
+        config.subassemblies[r.subassembly].reachability[r.agent] = r.reach;
+        if (!r.reach.reachable)
+            config.actions[r.reach.interaction.name] = r.reach.interaction;
+    }
+}
+
+Replanner::Replanner(Graph<AssemblyData,EdgeData> graph, config::Configuration config)
+  : graph_(std::move(graph)),
+    config_(std::move(config)),
+    expander_(graph_, tree_, config_, &statistics),
+    astar_(graph_, &statistics)
+{}
+
+const config::Configuration& Replanner::configuration() const
+{
+    return config_;
+}
+
+AssemblyPlan Replanner::plan()
+{
+    statistics = SearchStatistics();
+    tree_ = SearchTree();
+    tree_.retainStates(true);
+    discarded_.clear();
+
+    SearchData root_data = Planner::rootState(graph_);
+    root_data.minimum_cost_action = expander_.minimumActionCost(root_data);
+    root_ = tree_.insertRoot(std::move(root_data));
+
+    NodeIndex goal;
+    {
+        ScopedPhase phase(&statistics, "search");
+        astar_.open_list_type_ = detectOpenListType(config_);
+        goal = astar_.search(tree_, root_, expander_);
+    }
+    return backtrack(goal);
+}
+
+AssemblyPlan Replanner::update(const ConfigurationDelta& delta)
+{
+    if (root_ == SearchTree::none)
+    {
+        delta.apply(config_);
+        return plan();
+    }
+
+    statistics = SearchStatistics();
+    std::vector<NodeIndex> frontier;
+    {
+        ScopedPhase phase(&statistics, "repair");
+        TRACE_SCOPE("Replanner::repair", "search");
+        delta.apply(config_);
+        frontier = repair(delta);
+    }
+
+    NodeIndex goal;
+    {
+        ScopedPhase phase(&statistics, "search");
+        astar_.open_list_type_ = detectOpenListType(config_);
+        goal = astar_.search(tree_, frontier, expander_);
+    }
+    return backtrack(goal);
+}
+
+std::vector<NodeIndex> Replanner::repair(const ConfigurationDelta& delta)
+{
+    std::set<std::pair<Symbol, Symbol>> costs;
+    for (const auto& c : delta.costs)
+        costs.emplace(c.action, c.agent);
+    std::set<std::pair<Symbol, Symbol>> reach;
+    for (const auto& r : delta.reachability)
+        reach.emplace(r.subassembly, r.agent);
+
+    // Children are inserted after their parent, so the parents are repaired first.
+    // Rebuilt children are appended and already scored with the new configuration.
+    const std::size_t size = tree_.size();
+    discarded_.resize(size, false);
+    std::vector<bool> expanded(size, false);
+    for (NodeIndex id = 0; id < size; id++)
+    {
+        if (discarded_[id] || !tree_.hasParent(id))
+            continue;
+        NodeIndex parent = tree_.node(id).parent;
+        if (discarded_[parent])
+        {
+            discard(id);
+            continue;
+        }
+        expanded[parent] = true;
+
+        auto& edge = tree_.assignment(id);
+        bool rebuild = false;
+        bool rescore = false;
+        for (const auto& assignment : edge.planned_assignments)
+        {
+            rescore |= costs.count(std::make_pair(assignment.action, assignment.agent)) > 0;
+            for (auto successor : graph_.successorNodes(assignment.action_node_id))
+                rebuild |= reach.count(std::make_pair(graph_.getNodeData(successor).name, assignment.agent)) > 0;
+        }
+
+        if (rebuild)
+        {
+            auto assignments = edge.planned_assignments;
+            discard(id);
+            expander_.expandAssignment(parent, assignments);
+            continue;
+        }
+        if (rescore)
+        {
+            edge.cost = 0;
+            for (const auto& assignment : edge.planned_assignments)
+                edge.cost += config_.actions[assignment.action].costs[assignment.agent];
+            edge.cost /= edge.planned_assignments.size();
+        }
+        tree_.node(id).g_score = tree_.node(parent).g_score + edge.cost;
+    }
+    discarded_.resize(tree_.size(), false);
+    expanded.resize(tree_.size(), false);
+
+    // The heuristic of the leaves depends on the cheapest action cost of their state
+    std::vector<NodeIndex> frontier;
+    for (NodeIndex id = 0; id < tree_.size(); id++)
+    {
+        if (discarded_[id] || expanded[id])
+            continue;
+        if (!costs.empty())
+            tree_.setMinimumActionCost(id, expander_.minimumActionCost(tree_.state(id)));
+        frontier.push_back(id);
+    }
+    return frontier;
+}
+
+void Replanner::discard(NodeIndex id)
+{
+    discarded_[id] = true;
+    tree_.eraseState(id);
+}
+
+// Backtracking connects the selected interactions in the graph, the search continues on the original one
+AssemblyPlan Replanner::backtrack(NodeIndex goal)
+{
+    statistics.peak_search_bytes = tree_.peakBytes();
+    discarded_.resize(tree_.size(), false);
+    if (goal == SearchTree::none)
+        return AssemblyPlan();
+
+    ScopedPhase phase(&statistics, "backtrack");
+    auto graph = graph_;
+    return Planner::backtrack(graph, config_, tree_, goal);
+}
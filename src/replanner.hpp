@@ -0,0 +1,77 @@
+#pragma once
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "planner.hpp"
+
+// Change of the configuration between two plans, e.g. an agent slowing down or losing a tool
+struct ConfigurationDelta
+{
+    struct Cost
+    {
+        Symbol action;
+        Symbol agent;
+        double cost;
+    };
+
+    struct Reach
+    {
+        Symbol subassembly;
+        Symbol agent;
+        // The interaction (name and costs) is required if the subassembly becomes unreachable
+        config::Reach reach;
+    };
+
+    std::vector<Cost> costs;
+    std::vector<Reach> reachability;
+
+    void apply(config::Configuration&) const;
+};
+
+// Incremental replanning with the objective of the A* search.
+// The structure of the A/O graph, and with it the rounds available in every hypernode, does not depend
+// on the configuration. After a change, the search tree of the previous plan is therefore repaired
+// instead of being searched again, similar to LPA* on a tree:
+//  - a new cost changes the mean cost of the rounds containing the action-agent pair. The tree is stored
+//    in order of creation, so the g scores of these nodes and their subtrees are updated in one pass.
+//  - a new reachability changes the (interaction) subassemblies produced by rounds placing the subassembly
+//    with the agent. Such hypernodes are discarded with their subtrees and rebuilt from their parent.
+// The search then continues from the leaves of the repaired tree, and only expands the hypernodes which
+// are competitive under the new configuration.
+//
+// States of expanded hypernodes are retained to rebuild their children, and the tree is searched without
+// the incumbent bound, as children pruned by it could become competitive after a change.
+class Replanner
+{
+  public:
+    Replanner(Graph<AssemblyData,EdgeData>, config::Configuration);
+    Replanner(const Replanner&) = delete;
+
+    // Search the plan for the current configuration from scratch
+    AssemblyPlan plan();
+    // Apply the change to the configuration and plan again, reusing the search of the previous call
+    AssemblyPlan update(const ConfigurationDelta&);
+
+    const config::Configuration& configuration() const;
+
+    // Counters and phase timings of the last call
+    SearchStatistics statistics;
+
+  private:
+    // Update the tree to the changed configuration
+    //   \return: unexpanded hypernodes to continue the search from
+    std::vector<NodeIndex> repair(const ConfigurationDelta&);
+    void discard(NodeIndex);
+    AssemblyPlan backtrack(NodeIndex);
+
+    Graph<AssemblyData,EdgeData> graph_;
+    config::Configuration config_;
+    SearchTree tree_;
+    NodeExpander expander_;
+    AStarSearch astar_;
+    NodeIndex root_ = SearchTree::none;
+    // Hypernodes removed by a repair, together with their subtrees
+    std::vector<bool> discarded_;
+};
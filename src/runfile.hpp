@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "types.hpp"
+
+// Hypernode written to a run file: the graph nodes of its open subassemblies and actions.
+// Names are taken from the graph when the state is rebuilt, scores stay in the search tree.
+struct StateRecord
+{
+    NodeIndex node = 0;
+    // Sorted node ids
+    std::vector<NodeIndex> subassemblies;
+    std::vector<NodeIndex> actions;
+};
+
+inline bool operator==(const StateRecord &lhs, const StateRecord &rhs)
+{
+    return lhs.subassemblies == rhs.subassemblies && lhs.actions == rhs.actions;
+}
+
+// Sequential writer of a run file. Records are stored as LEB128 varints, the sorted node ids of a
+// state as differences to their predecessor, which takes one or two bytes per entry on typical graphs.
+// The primitives are also used for the search checkpoints.
+// The file is written through a POSIX descriptor, so that it can be synced to disk when it is closed.
+class RunWriter
+{
+  public:
+    RunWriter() = default;
+    RunWriter(const RunWriter &) = delete;
+    RunWriter &operator=(const RunWriter &) = delete;
+    ~RunWriter();
+
+    bool open(const std::string &);
+    void write(const StateRecord &);
+    // Flush the buffer and close the file
+    //   @sync:   wait until the data is on disk, before the file is e.g. renamed over a previous version
+    //   \return: false if writing failed at any point
+    bool close(bool sync = false);
+    // Bytes written so far
+    std::size_t bytes() const;
+
+    void putVarint(std::uint64_t);
+    // Sorted ids, as differences
+    void putIds(const std::vector<NodeIndex> &);
+    void putFixed64(std::uint64_t);
+    void putDouble(double);
+    void putString(const std::string &);
+
+  private:
+    void flush();
+
+    static constexpr std::size_t buffer_size = 1 << 20;
+
+    int fd_ = -1;
+    bool failed_ = false;
+    std::string buffer_;
+    std::size_t bytes_ = 0;
+};
+
+// Sequential reader of a run file written by `RunWriter`
+class RunReader
+{
+  public:
+    bool open(const std::string &);
+    // Read the next record
+    //   \return: false at the end of the file or if the file is truncated
+    bool next(StateRecord &);
+
+    // The getters return false at the end of the file
+    bool getVarint(std::uint64_t &);
+    bool getIds(std::vector<NodeIndex> &);
+    bool getFixed64(std::uint64_t &);
+    bool getDouble(double &);
+    bool getString(std::string &);
+
+  private:
+    bool fill();
+
+    static constexpr std::size_t buffer_size = 1 << 20;
+
+    std::ifstream in_;
+    std::vector<char> buffer_;
+    std::size_t pos_ = 0;
+    std::size_t end_ = 0;
+};
+
+inline RunWriter::~RunWriter()
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+inline bool RunWriter::open(const std::string &path)
+{
+    if (fd_ >= 0)
+        ::close(fd_);
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    failed_ = fd_ < 0;
+    buffer_.clear();
+    buffer_.reserve(buffer_size);
+    bytes_ = 0;
+    return !failed_;
+}
+
+inline void RunWriter::write(const StateRecord &record)
+{
+    putVarint(record.node);
+    putIds(record.subassemblies);
+    putIds(record.actions);
+}
+
+inline bool RunWriter::close(bool sync)
+{
+    flush();
+    if (fd_ < 0)
+        return false;
+    if (sync && ::fsync(fd_) != 0)
+        failed_ = true;
+    if (::close(fd_) != 0)
+        failed_ = true;
+    fd_ = -1;
+    return !failed_;
+}
+
+inline std::size_t RunWriter::bytes() const
+{
+    return bytes_ + buffer_.size();
+}
+
+inline void RunWriter::putVarint(std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer_.push_back(char(value | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(char(value));
+    if (buffer_.size() >= buffer_size)
+        flush();
+}
+
+inline void RunWriter::putIds(const std::vector<NodeIndex> &ids)
+{
+    putVarint(ids.size());
+    NodeIndex previous = 0;
+    for (auto id : ids)
+    {
+        putVarint(id - previous);
+        previous = id;
+    }
+}
+
+inline void RunWriter::putFixed64(std::uint64_t value)
+{
+    for (unsigned i = 0; i < 8; i++)
+        buffer_.push_back(char(value >> (8 * i)));
+    if (buffer_.size() >= buffer_size)
+        flush();
+}
+
+inline void RunWriter::putDouble(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putFixed64(bits);
+}
+
+inline void RunWriter::putString(const std::string &value)
+{
+    putVarint(value.size());
+    buffer_.append(value);
+    if (buffer_.size() >= buffer_size)
+        flush();
+}
+
+inline void RunWriter::flush()
+{
+    std::size_t written = 0;
+    while (fd_ >= 0 && !failed_ && written < buffer_.size())
+    {
+        auto n = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            failed_ = true;
+        else
+            written += n;
+    }
+    bytes_ += buffer_.size();
+    buffer_.clear();
+}
+
+inline bool RunReader::open(const std::string &path)
+{
+    in_.open(path, std::ios::binary);
+    buffer_.resize(buffer_size);
+    pos_ = end_ = 0;
+    return bool(in_);
+}
+
+inline bool RunReader::next(StateRecord &record)
+{
+    std::uint64_t node;
+    if (!getVarint(node))
+        return false;
+    record.node = node;
+    return getIds(record.subassemblies) && getIds(record.actions);
+}
+
+inline bool RunReader::fill()
+{
+    if (!in_)
+        return false;
+    in_.read(buffer_.data(), buffer_.size());
+    pos_ = 0;
+    end_ = in_.gcount();
+    return end_ > 0;
+}
+
+inline bool RunReader::getVarint(std::uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (pos_ == end_ && !fill())
+            return false;
+        auto byte = static_cast<unsigned char>(buffer_[pos_++]);
+        value |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline bool RunReader::getIds(std::vector<NodeIndex> &ids)
+{
+    std::uint64_t count;
+    if (!getVarint(count))
+        return false;
+    ids.clear();
+    NodeIndex previous = 0;
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        std::uint64_t delta;
+        if (!getVarint(delta))
+            return false;
+        previous += delta;
+        ids.push_back(previous);
+    }
+    return true;
+}
+
+inline bool RunReader::getFixed64(std::uint64_t &value)
+{
+    value = 0;
+    for (unsigned i = 0; i < 8; i++)
+    {
+        if (pos_ == end_ && !fill())
+            return false;
+        value |= std::uint64_t(static_cast<unsigned char>(buffer_[pos_++])) << (8 * i);
+    }
+    return true;
+}
+
+inline bool RunReader::getDouble(double &value)
+{
+    std::uint64_t bits;
+    if (!getFixed64(bits))
+        return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+inline bool RunReader::getString(std::string &value)
+{
+    std::uint64_t size;
+    if (!getVarint(size))
+        return false;
+    value.clear();
+    while (value.size() < size)
+    {
+        if (pos_ == end_ && !fill())
+            return false;
+        auto n = std::min<std::size_t>(size - value.size(), end_ - pos_);
+        value.append(buffer_.data() + pos_, n);
+        pos_ += n;
+    }
+    return true;
+}
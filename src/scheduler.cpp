@@ -0,0 +1,143 @@
+#include "scheduler.hpp"
+
+Scheduler::Scheduler(config::Configuration& config)
+  : config_(config)
+{}
+
+void Schedule::print(std::ostream& os) const
+{
+    for (const auto& a : actions)
+    {
+        os << " [" << nameOf(a.action) << " - " << nameOf(a.agent) << "] "
+           << a.start << " - " << a.end << std::endl;
+    }
+    os << std::endl << "Makespan: " << makespan << std::endl << std::endl;
+}
+
+Schedule Scheduler::schedule(AssemblyPlan& plan)
+{
+    TRACE_SCOPE("Scheduler::schedule", "schedule");
+
+    auto& graph = plan.graph;
+    auto isAction = [](const AssemblyData& data)
+    {
+        return data.type == NodeType::ACTION || data.type == NodeType::INTERACTION;
+    };
+
+    // Actions of the plan with their durations and dependencies.
+    // The subassemblies below an action (interassemblies included) are disassembled by the actions
+    // following them, which have to be done before the action can join them.
+    std::vector<NodeIndex> ids;
+    for (auto node : graph.nodes())
+    {
+        if (isAction(node->data))
+            ids.push_back(node->id);
+    }
+    std::sort(ids.begin(), ids.end());
+    std::unordered_map<NodeIndex, std::size_t> index;
+    for (std::size_t i = 0; i < ids.size(); i++)
+        index[ids[i]] = i;
+
+    const std::size_t n = ids.size();
+    std::vector<double> duration;
+    std::vector<std::vector<std::size_t>> dependencies(n), dependents(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const auto& data = graph.getNodeData(ids[i]);
+        duration.push_back(config_.actions.at(data.name).costs.at(data.assigned_agent));
+        for (auto sa : graph.successorNodes(ids[i]))
+        {
+            for (auto next : graph.successorNodes(sa))
+            {
+                if (!isAction(graph.getNodeData(next)))
+                    continue;
+                dependencies[i].push_back(index.at(next));
+                dependents[index.at(next)].push_back(i);
+            }
+        }
+    }
+
+    // Longest chain of durations from the start of an action to the end of the plan
+    std::vector<double> tail(n, -1);
+    std::vector<std::size_t> order;
+    std::vector<std::size_t> missing(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        missing[i] = dependents[i].size();
+        if (missing[i] == 0)
+            order.push_back(i);
+    }
+    for (std::size_t k = 0; k < order.size(); k++)
+    {
+        auto i = order[k];
+        tail[i] = duration[i];
+        for (auto d : dependents[i])
+            tail[i] = std::max(tail[i], duration[i] + tail[d]);
+        for (auto p : dependencies[i])
+        {
+            if (--missing[p] == 0)
+                order.push_back(p);
+        }
+    }
+
+    // Busy intervals of every agent, sorted by their start
+    std::unordered_map<Symbol, std::vector<std::pair<double, double>>> busy;
+    std::vector<double> end(n, 0);
+    std::vector<std::size_t> ready;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        missing[i] = dependencies[i].size();
+        if (missing[i] == 0)
+            ready.push_back(i);
+    }
+
+    Schedule schedule;
+    while (!ready.empty())
+    {
+        auto it = std::max_element(ready.begin(), ready.end(), [&](std::size_t a, std::size_t b)
+        {
+            return tail[a] != tail[b] ? tail[a] < tail[b] : a > b;
+        });
+        auto i = *it;
+        ready.erase(it);
+
+        double release = 0;
+        for (auto d : dependencies[i])
+            release = std::max(release, end[d]);
+
+        // First gap of the agent which fits the action
+        const auto& data = graph.getNodeData(ids[i]);
+        auto& intervals = busy[data.assigned_agent];
+        double start = release;
+        auto pos = intervals.begin();
+        for (; pos != intervals.end(); ++pos)
+        {
+            if (start + duration[i] <= pos->first)
+                break;
+            start = std::max(start, pos->second);
+        }
+        intervals.insert(pos, std::make_pair(start, start + duration[i]));
+        end[i] = start + duration[i];
+
+        ScheduledAction scheduled;
+        scheduled.action = data.name;
+        scheduled.agent = data.assigned_agent;
+        scheduled.action_node_id = ids[i];
+        scheduled.start = start;
+        scheduled.end = end[i];
+        for (auto d : dependencies[i])
+            scheduled.dependencies.push_back(graph.getNodeData(ids[d]).name);
+        schedule.actions.push_back(std::move(scheduled));
+        schedule.makespan = std::max(schedule.makespan, end[i]);
+
+        for (auto d : dependents[i])
+        {
+            if (--missing[d] == 0)
+                ready.push_back(d);
+        }
+    }
+
+    std::stable_sort(schedule.actions.begin(), schedule.actions.end(),
+                     [](const ScheduledAction& a, const ScheduledAction& b) { return a.start < b.start; });
+    return schedule;
+}
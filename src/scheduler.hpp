@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graph.hpp"
+#include "plan.hpp"
+#include "trace.hpp"
+#include "types.hpp"
+
+// Action of a plan placed on the timeline of its agent
+struct ScheduledAction
+{
+    Symbol action;
+    Symbol agent;
+    // Node of the action in the plan graph
+    NodeIndex action_node_id;
+    double start = 0;
+    double end = 0;
+    // Actions producing the subassemblies consumed by this one, they end before it starts
+    std::vector<Symbol> dependencies;
+};
+
+// Timed execution of a plan, the actions are ordered by their start time
+struct Schedule
+{
+    std::vector<ScheduledAction> actions;
+    // End of the last action
+    double makespan = 0;
+
+    void print(std::ostream&) const;
+};
+
+// Post-pass turning the actions of a plan into a schedule.
+// Action costs are taken as durations. An action can start once the actions producing its
+// input subassemblies have ended and its agent is idle; the agent is fixed by the plan.
+// The rounds of the plan are not used, only the dependencies of the plan graph.
+//
+// List scheduling: of the actions whose dependencies are placed, the one with the longest path
+// of durations to the end of the plan (the critical path) is placed first, at the earliest time
+// its agent is idle for its duration, which can be a gap between actions placed before.
+class Scheduler
+{
+  public:
+    Scheduler(config::Configuration&);
+
+    Schedule schedule(AssemblyPlan&);
+
+  private:
+    config::Configuration& config_;
+};
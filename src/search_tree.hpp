@@ -0,0 +1,298 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+using StateHandle = std::size_t;
+using AssignmentHandle = std::size_t;
+
+// Hypernode of the search. The search only ever walks from a node to its parent
+// (to backtrack the plan), so no adjacency is stored.
+struct SearchNode
+{
+    NodeIndex parent;
+    double g_score;
+    double h_score;
+    // Index of the subassembly/action state, `SearchTree::none` once the node was expanded.
+    // Nodes with equal states share one index.
+    StateHandle state;
+    // Index of the assignments leading from the parent to this node
+    AssignmentHandle assignment;
+    // Zobrist hash of the state, kept after the state is released
+    std::uint64_t hash;
+
+    double f_score() const { return g_score + h_score; }
+};
+
+// Contiguous store of the hypernodes produced by the search.
+// Children are appended by the `NodeExpander` and referenced by index from the open list.
+// States are only needed until a node is expanded; releasing them afterwards keeps the memory
+// proportional to the open list, while the tree itself holds a few words per node.
+// States are hash-consed: a node whose state equals a live one refers to the stored copy, which is
+// freed with its last node. Together with the structural sharing of `PersistentMap` a new state
+// costs the memory of the entries its assignment changed.
+class SearchTree
+{
+  public:
+    static constexpr std::size_t none = SIZE_MAX;
+
+    NodeIndex insertRoot(SearchData);
+    NodeIndex insertNode(NodeIndex parent, double g_score, SearchData, EdgeData);
+
+    SearchNode& node(NodeIndex);
+    const SearchNode& node(NodeIndex) const;
+    const SearchData& state(NodeIndex) const;
+    // Update the heuristic input of a state after the configuration changed, for all nodes sharing it
+    void setMinimumActionCost(NodeIndex, double);
+    bool hasState(NodeIndex) const;
+    const EdgeData& assignment(NodeIndex) const;
+    EdgeData& assignment(NodeIndex);
+    bool hasParent(NodeIndex) const;
+
+    // Keep the states of expanded nodes, so a node can be expanded again after the configuration changed
+    void retainStates(bool);
+    // Drop the reference of an expanded node to its state, the slot is reused once no node refers to it.
+    // States are kept while `retainStates` is set.
+    void releaseState(NodeIndex);
+    // Drop the reference of a node to its state even if states are retained
+    void eraseState(NodeIndex);
+    // Store the state of a node again, after it was erased to keep it outside of memory
+    void restoreState(NodeIndex, SearchData);
+
+    // Drop the nodes not in `keep` together with their states and assignments, and renumber the kept ones
+    // in their order. The parent of every kept node must be kept.
+    //   \return: new index of every node, `none` for the dropped ones
+    std::vector<NodeIndex> compact(const std::vector<bool>& keep);
+
+    std::size_t size() const;
+    // Distinct states referenced by the nodes
+    std::size_t liveStates() const;
+    // Approximate memory used by nodes, live states and assignments
+    std::size_t bytes() const;
+    std::size_t peakBytes() const;
+
+  private:
+    struct StateSlot
+    {
+        SearchData data;
+        // Nodes referring to the state, 0 for a free slot
+        std::size_t users = 0;
+        // Memory accounted for the state when it was stored
+        std::size_t bytes = 0;
+    };
+
+    static std::size_t stateBytes(const SearchData&);
+    static std::size_t nodeBytes(const EdgeData&);
+    StateHandle storeState(SearchData);
+    void addBytes(std::size_t);
+
+    std::vector<SearchNode> nodes_;
+    std::vector<StateSlot> states_;
+    std::vector<StateHandle> free_states_;
+    // Live states by their Zobrist hash
+    std::unordered_multimap<std::uint64_t, StateHandle> state_index_;
+    std::vector<EdgeData> assignments_;
+
+    bool retain_states_ = false;
+    std::size_t bytes_ = 0;
+    std::size_t peak_bytes_ = 0;
+};
+
+inline NodeIndex SearchTree::insertRoot(SearchData data)
+{
+    return insertNode(none, 0, std::move(data), EdgeData());
+}
+
+inline NodeIndex SearchTree::insertNode(NodeIndex parent, double g_score, SearchData data, EdgeData edge)
+{
+    NodeIndex id = nodes_.size();
+    addBytes(nodeBytes(edge));
+
+    std::uint64_t hash = data.hash;
+    StateHandle state = storeState(std::move(data));
+    nodes_.push_back(SearchNode{parent, g_score, 0, state, assignments_.size(), hash});
+    assignments_.push_back(std::move(edge));
+    return id;
+}
+
+inline StateHandle SearchTree::storeState(SearchData data)
+{
+    auto range = state_index_.equal_range(data.hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto& slot = states_[it->second];
+        if (slot.data.subassemblies == data.subassemblies && slot.data.actions == data.actions)
+        {
+            slot.users++;
+            return it->second;
+        }
+    }
+
+    StateHandle handle;
+    if (free_states_.empty())
+    {
+        handle = states_.size();
+        states_.emplace_back();
+    }
+    else
+    {
+        handle = free_states_.back();
+        free_states_.pop_back();
+    }
+    auto& slot = states_[handle];
+    slot.bytes = stateBytes(data);
+    slot.users = 1;
+    slot.data = std::move(data);
+    addBytes(slot.bytes);
+    state_index_.emplace(slot.data.hash, handle);
+    return handle;
+}
+
+inline void SearchTree::retainStates(bool retain)
+{
+    retain_states_ = retain;
+}
+
+inline void SearchTree::releaseState(NodeIndex id)
+{
+    if (!retain_states_)
+        eraseState(id);
+}
+
+inline void SearchTree::eraseState(NodeIndex id)
+{
+    auto& n = nodes_[id];
+    if (n.state == none)
+        return;
+    auto& slot = states_[n.state];
+    if (--slot.users == 0)
+    {
+        auto range = state_index_.equal_range(slot.data.hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == n.state)
+            {
+                state_index_.erase(it);
+                break;
+            }
+        }
+        bytes_ -= slot.bytes;
+        slot.data = SearchData();
+        free_states_.push_back(n.state);
+    }
+    n.state = none;
+}
+
+inline void SearchTree::restoreState(NodeIndex id, SearchData data)
+{
+    eraseState(id);
+    nodes_[id].state = storeState(std::move(data));
+}
+
+inline SearchNode& SearchTree::node(NodeIndex id)
+{
+    return nodes_[id];
+}
+
+inline const SearchNode& SearchTree::node(NodeIndex id) const
+{
+    return nodes_[id];
+}
+
+inline const SearchData& SearchTree::state(NodeIndex id) const
+{
+    return states_[nodes_[id].state].data;
+}
+
+inline void SearchTree::setMinimumActionCost(NodeIndex id, double cost)
+{
+    states_[nodes_[id].state].data.minimum_cost_action = cost;
+}
+
+inline bool SearchTree::hasState(NodeIndex id) const
+{
+    return nodes_[id].state != none;
+}
+
+inline const EdgeData& SearchTree::assignment(NodeIndex id) const
+{
+    return assignments_[nodes_[id].assignment];
+}
+
+inline EdgeData& SearchTree::assignment(NodeIndex id)
+{
+    return assignments_[nodes_[id].assignment];
+}
+
+inline bool SearchTree::hasParent(NodeIndex id) const
+{
+    return nodes_[id].parent != none;
+}
+
+inline std::vector<NodeIndex> SearchTree::compact(const std::vector<bool>& keep)
+{
+    std::vector<NodeIndex> index(nodes_.size(), none);
+    NodeIndex next = 0;
+    for (NodeIndex id = 0; id < nodes_.size(); id++)
+    {
+        if (!keep[id])
+        {
+            eraseState(id);
+            bytes_ -= nodeBytes(assignments_[nodes_[id].assignment]);
+            continue;
+        }
+        auto node = nodes_[id];
+        if (node.parent != none)
+            node.parent = index[node.parent];
+        if (node.assignment != next)
+            assignments_[next] = std::move(assignments_[node.assignment]);
+        node.assignment = next;
+        nodes_[next] = node;
+        index[id] = next++;
+    }
+    nodes_.resize(next);
+    assignments_.resize(next);
+    return index;
+}
+
+inline std::size_t SearchTree::size() const
+{
+    return nodes_.size();
+}
+
+inline std::size_t SearchTree::liveStates() const
+{
+    return states_.size() - free_states_.size();
+}
+
+inline std::size_t SearchTree::bytes() const
+{
+    return bytes_;
+}
+
+inline std::size_t SearchTree::peakBytes() const
+{
+    return peak_bytes_;
+}
+
+inline void SearchTree::addBytes(std::size_t bytes)
+{
+    bytes_ += bytes;
+    peak_bytes_ = std::max(peak_bytes_, bytes_);
+}
+
+// Memory held by a state alone: the buckets its maps do not share with another state, usually only the
+// ones the assignment leading to it changed. The keys are interned names and hold no memory of their own.
+inline std::size_t SearchTree::stateBytes(const SearchData& data)
+{
+    return sizeof(StateSlot) + data.subassemblies.ownedBytes() + data.actions.ownedBytes();
+}
+
+inline std::size_t SearchTree::nodeBytes(const EdgeData& edge)
+{
+    return sizeof(SearchNode) + sizeof(EdgeData) + edge.planned_assignments.capacity() * sizeof(AgentActionAssignment);
+}
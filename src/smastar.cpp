@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cmath>
+
+#include "smastar.hpp"
+
+// Nodes of the open list are held by a balanced tree, each with three pointers and a color
+static constexpr std::size_t open_node_bytes = sizeof(OpenEntry) + 4 * sizeof(void*);
+
+SMAStarSearch::SMAStarSearch(Graph<AssemblyData,EdgeData>& assembly, SearchStatistics* stats,
+                             std::size_t memory_limit, double minimum_cost)
+  : assembly_(assembly),
+    stats_(stats ? stats : &own_stats_),
+    astar_(assembly),
+    memory_limit_(memory_limit)
+{
+    // A weight of 1 keeps the order of A*, only the lower bound of the focal search is used
+    astar_.setFocal(1, minimum_cost);
+}
+
+void SMAStarSearch::setBound(double bound)
+{
+    bound_ = bound;
+}
+
+void SMAStarSearch::setControl(const PlanningControl* control)
+{
+    monitor_ = SearchMonitor(control);
+}
+
+// Perform the graph search:
+//   @tree:     search tree containing the root, children are appended by the expander.
+//   @root:     index of the node at which the search should begin.
+//   @expander: expander object used for node expansion, its children are fully generated.
+//
+NodeIndex SMAStarSearch::search(SearchTree& tree, NodeIndex root, NodeExpander& expander)
+{
+    TRACE_SCOPE("SMAStarSearch::search", "search");
+
+    records_.assign(tree.size(), Record());
+    cut_ = false;
+    auto& root_node = tree.node(root);
+    root_node.h_score = astar_.lowerBound(tree.state(root));
+    records_[root].live = true;
+    records_[root].key = root_node.f_score();
+    push(tree, root);
+    stats_->nodes_generated++;
+
+    while (!open_.empty())
+    {
+        if (monitor_.poll([&] { return SearchProgress{stats_->nodes_expanded, open_.begin()->f_score, bound_}; }))
+            return SearchTree::none;
+
+        NodeIndex current = open_.begin()->index;
+        erase(tree, current);
+
+        if (!records_[current].expanded && astar_.isGoal(assembly_, tree.state(current)))
+            return current;
+
+        expand(tree, current, expander);
+        if (!enforce(tree, current))
+        {
+            // Only the path and the children of the node are left, none of them can reach a goal.
+            // Without a path to cut, not even the root fits.
+            cut_ = true;
+            if (current == SearchTree::none || tree.node(current).parent == SearchTree::none)
+                break;
+            cut(tree, current);
+            NodeIndex none = SearchTree::none;
+            enforce(tree, none);
+        }
+        stats_->open_list_peak = std::max(stats_->open_list_peak, open_.size());
+    }
+    if (cut_)
+    {
+        std::cerr << "SEARCH ERROR: A memory budget of " << memory_limit_
+                  << " bytes cannot hold the path to a goal" << std::endl;
+    }
+    return SearchTree::none;
+}
+
+void SMAStarSearch::expand(SearchTree& tree, NodeIndex id, NodeExpander& expander)
+{
+    std::pair<NodeIndex, NodeIndex> children;
+    {
+        TRACE_SCOPE("NodeExpander::expandNode", "search");
+        children = expander.expandNode(id);
+    }
+    records_.resize(tree.size());
+
+    auto& record = records_[id];
+    bool regenerate = record.expanded;
+    std::size_t count = children.second - children.first;
+    if (!regenerate)
+    {
+        record.forgotten.assign(count, NAN);
+        forgotten_bytes_ += count * sizeof(double);
+    }
+
+    for (NodeIndex child = children.first; child < children.second; child++)
+    {
+        std::size_t ordinal = child - children.first;
+        auto& node = tree.node(child);
+        auto& child_record = records_[child];
+        child_record.ordinal = ordinal;
+        // Children still in the tree or removed for good are generated again as well
+        if (regenerate && std::isnan(record.forgotten[ordinal]))
+        {
+            tree.eraseState(child);
+            removed_++;
+            continue;
+        }
+        // A new child takes at least the score of its parent, a regenerated one the score it was forgotten with
+        double floor = regenerate ? record.forgotten[ordinal] : record.key;
+        node.h_score = astar_.lowerBound(tree.state(child));
+        double f = std::max(node.f_score(), floor);
+        if (f > bound_)
+        {
+            stats_->nodes_pruned++;
+            tree.eraseState(child);
+            removed_++;
+            continue;
+        }
+        child_record.live = true;
+        child_record.key = f;
+        record.children++;
+        push(tree, child);
+    }
+    std::fill(record.forgotten.begin(), record.forgotten.end(), NAN);
+    record.expanded = true;
+    record.key = INFINITY;
+
+    // Every child is pruned, nothing below the node can improve on the incumbent
+    if (record.children == 0)
+        remove(tree, id, false);
+}
+
+void SMAStarSearch::remove(SearchTree& tree, NodeIndex id, bool remember)
+{
+    auto& record = records_[id];
+    double key = record.key;
+    std::size_t ordinal = record.ordinal;
+    if (record.open)
+        erase(tree, id);
+    forgotten_bytes_ -= record.forgotten.size() * sizeof(double);
+    record = Record();
+    tree.eraseState(id);
+    removed_++;
+
+    auto parent = tree.node(id).parent;
+    if (parent == SearchTree::none)
+        return;
+    auto& parent_record = records_[parent];
+    parent_record.children--;
+    if (remember)
+    {
+        parent_record.forgotten[ordinal] = key;
+        if (key < parent_record.key)
+        {
+            if (parent_record.open)
+                erase(tree, parent);
+            parent_record.key = key;
+            push(tree, parent);
+        }
+    }
+    else if (parent_record.children == 0 && std::isinf(parent_record.key))
+    {
+        remove(tree, parent, false);
+    }
+}
+
+void SMAStarSearch::cut(SearchTree& tree, NodeIndex id)
+{
+    std::vector<NodeIndex> children;
+    for (const auto& entry : open_)
+    {
+        if (tree.node(entry.index).parent == id)
+            children.push_back(entry.index);
+    }
+    // The last child removes the node, unless it was left without children already
+    for (auto child : children)
+        remove(tree, child, false);
+    if (children.empty())
+        remove(tree, id, false);
+}
+
+bool SMAStarSearch::enforce(SearchTree& tree, NodeIndex& current)
+{
+    while (bytes(tree) > memory_limit_)
+    {
+        if (removed_ > 0 && removed_ * 4 >= tree.size())
+        {
+            compact(tree, current);
+            continue;
+        }
+
+        // Worst leaf, the open list orders equal f scores by decreasing g score
+        auto victim = open_.rbegin();
+        for (; victim != open_.rend(); ++victim)
+        {
+            const auto& node = tree.node(victim->index);
+            if (records_[victim->index].children == 0 && node.parent != SearchTree::none && node.parent != current)
+                break;
+        }
+        if (victim == open_.rend())
+        {
+            if (removed_ == 0)
+                return false;
+            compact(tree, current);
+            continue;
+        }
+        remove(tree, victim->index, true);
+        stats_->nodes_forgotten++;
+    }
+    return true;
+}
+
+void SMAStarSearch::compact(SearchTree& tree, NodeIndex& current)
+{
+    TRACE_SCOPE("SMAStarSearch::compact", "search");
+
+    std::vector<bool> keep(records_.size());
+    for (NodeIndex id = 0; id < records_.size(); id++)
+        keep[id] = records_[id].live;
+    auto index = tree.compact(keep);
+
+    for (NodeIndex id = 0; id < records_.size(); id++)
+    {
+        if (index[id] != SearchTree::none && index[id] != id)
+            records_[index[id]] = std::move(records_[id]);
+    }
+    records_.resize(tree.size());
+
+    std::set<OpenEntry> open;
+    for (auto entry : open_)
+    {
+        entry.index = index[entry.index];
+        open.insert(open.end(), entry);
+    }
+    open_ = std::move(open);
+    if (current != SearchTree::none)
+        current = index[current];
+    removed_ = 0;
+}
+
+void SMAStarSearch::push(SearchTree& tree, NodeIndex id)
+{
+    records_[id].open = true;
+    open_.insert(OpenEntry{records_[id].key, tree.node(id).g_score, id});
+}
+
+void SMAStarSearch::erase(SearchTree& tree, NodeIndex id)
+{
+    records_[id].open = false;
+    open_.erase(OpenEntry{records_[id].key, tree.node(id).g_score, id});
+}
+
+std::size_t SMAStarSearch::bytes(const SearchTree& tree) const
+{
+    return tree.bytes() + records_.size() * sizeof(Record) + forgotten_bytes_ + open_.size() * open_node_bytes;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "astar.hpp"
+
+// Simplified memory-bounded A* (SMA*): the search tree and the bookkeeping of the search are kept within
+// `memory_limit` bytes, as accounted by `SearchTree::bytes`.
+// Nodes are ordered by the admissible lower bound of the focal search (`AStarSearch::lowerBound`), and a
+// child takes at least the f score of its parent. Whenever an expansion exceeds the budget, the open leaf
+// with the highest f score, the shallowest among equal ones, is forgotten: it is removed from the tree and
+// its parent keeps its f score. A parent with forgotten children is on the open list with the lowest of
+// their scores and regenerates them with the scores it kept when it is selected, so backed-up scores are
+// not lost; once all its children are forgotten it is a leaf itself and may be forgotten in turn.
+// A node whose children do not fit into the budget next to its path cannot lead to a plan within it: it
+// is removed for good, and so is a parent left without children to regenerate.
+// Every path not explored yet passes an entry of the open list whose f score does not exceed its cost, so
+// the first goal taken from the open list is the optimal plan whose path fits into the budget.
+// Expanded nodes keep their states to regenerate their children; the records of forgotten nodes are
+// reclaimed by compacting the tree, which renumbers the nodes.
+class SMAStarSearch
+{
+  public:
+    // @memory_limit: bytes of the search tree and the open list
+    // @minimum_cost: cheapest cost of any action for any agent, see `NodeExpander::cheapestAction`
+    SMAStarSearch(Graph<AssemblyData,EdgeData>&, SearchStatistics*, std::size_t memory_limit, double minimum_cost);
+
+    //   \return: index of the goal node, or `SearchTree::none` if every goal exceeds the bound,
+    //            the search was stopped by its control or the budget cannot hold the path to any goal
+    NodeIndex search(SearchTree&, NodeIndex, NodeExpander&);
+
+    // Cost of the incumbent plan, nodes with a higher f score are not added to the open list
+    void setBound(double);
+    // Stop the search on cancellation or at the deadline, and report its progress
+    void setControl(const PlanningControl*);
+
+  private:
+    struct Record
+    {
+        // Entry on the open list: the f score of a leaf, the lowest f score of the forgotten
+        // children of an expanded node, INFINITY if it has none
+        double key = INFINITY;
+        bool open = false;
+        bool expanded = false;
+        bool live = false;
+        // Children in the tree
+        std::uint32_t children = 0;
+        // Position among the children generated by the parent
+        std::uint32_t ordinal = 0;
+        // Keys of the forgotten children by ordinal, NAN for children in the tree or removed for good
+        std::vector<double> forgotten;
+    };
+
+    // Expand a leaf, or regenerate the forgotten children of an expanded node
+    void expand(SearchTree&, NodeIndex, NodeExpander&);
+    // Remove a leaf from the tree. With `remember` its parent keeps its key to regenerate it;
+    // a parent left without children and without forgotten ones is removed as well.
+    void remove(SearchTree&, NodeIndex, bool remember);
+    // Remove the children of a node whose path cannot hold them, and with them the node
+    void cut(SearchTree&, NodeIndex);
+    // Forget leaves until the memory is within the budget. The children of `current` are kept,
+    // its index is updated if the tree is compacted.
+    //   \return: false if the budget is exceeded and nothing can be forgotten
+    bool enforce(SearchTree&, NodeIndex& current);
+    // Drop the records of removed nodes from the tree
+    void compact(SearchTree&, NodeIndex& current);
+
+    void push(SearchTree&, NodeIndex);
+    void erase(SearchTree&, NodeIndex);
+    // Memory of the tree, the records and the open list
+    std::size_t bytes(const SearchTree&) const;
+
+    Graph<AssemblyData,EdgeData>& assembly_;
+    SearchStatistics own_stats_;
+    SearchStatistics* stats_;
+    // Goal test and lower bound
+    AStarSearch astar_;
+    std::size_t memory_limit_;
+    double bound_ = INFINITY;
+    SearchMonitor monitor_;
+
+    std::set<OpenEntry> open_;
+    std::vector<Record> records_;
+    // Removed nodes still in the tree
+    std::size_t removed_ = 0;
+    // Bytes of the `forgotten` vectors
+    std::size_t forgotten_bytes_ = 0;
+    // Whether a node was cut because of the budget
+    bool cut_ = false;
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Wall-clock and CPU time spent in one phase of the planning process
+struct PhaseTiming
+{
+    std::string name;
+    double wall_ms = 0;
+    double cpu_ms = 0;
+};
+
+// Counters collected during planning.
+// The counters are plain integers incremented inline by the search components,
+// the phase timings are recorded by `ScopedPhase` objects.
+struct SearchStatistics
+{
+    // Hypernodes inserted into the search graph (including the root)
+    std::size_t nodes_generated = 0;
+    // Calls to `NodeExpander::expandNode`
+    std::size_t nodes_expanded = 0;
+    // Maximum number of entries in the open list
+    std::size_t open_list_peak = 0;
+    // Generated hypernodes discarded because an equivalent one was already known
+    std::size_t duplicate_hits = 0;
+    // Assignments and hypernodes discarded because they cannot improve on the incumbent plan
+    std::size_t nodes_pruned = 0;
+    // Agent-action assignments produced by the `Combinator`
+    std::size_t assignments_enumerated = 0;
+    // Interaction nodes inserted into the assembly graph
+    std::size_t interaction_nodes = 0;
+    // Approximate peak memory used by the search graph
+    std::size_t peak_search_bytes = 0;
+    // Hypernodes whose state was written to a run file by the external-memory search
+    std::size_t nodes_spilled = 0;
+    // Bytes written to run files, including merges
+    std::size_t spill_bytes = 0;
+    // Hypernodes removed by the memory-bounded search to stay within its budget
+    std::size_t nodes_forgotten = 0;
+    // Hypernodes discarded before their expansion because an expanded one dominates them
+    std::size_t nodes_dominated = 0;
+
+    // Timings in the order the phases were first entered
+    std::vector<PhaseTiming> phases;
+
+    // Add the given time to a phase, creating the phase if necessary
+    void addPhase(const std::string &, double, double);
+
+    void print(std::ostream &) const;
+    void writeJson(std::ostream &) const;
+};
+
+inline void SearchStatistics::addPhase(const std::string &name, double wall_ms, double cpu_ms)
+{
+    for (auto &phase : phases)
+    {
+        if (phase.name == name)
+        {
+            phase.wall_ms += wall_ms;
+            phase.cpu_ms += cpu_ms;
+            return;
+        }
+    }
+    phases.push_back(PhaseTiming{name, wall_ms, cpu_ms});
+}
+
+inline void SearchStatistics::print(std::ostream &os) const
+{
+    os << "+---------------------------------------------------+" << std::endl;
+    os << "| STATISTICS                                        |" << std::endl;
+    os << "+---------------------------------------------------+" << std::endl;
+    os << std::left;
+    os << "|  Nodes generated:          " << std::setw(23) << nodes_generated << "|" << std::endl;
+    os << "|  Nodes expanded:           " << std::setw(23) << nodes_expanded << "|" << std::endl;
+    os << "|  Open list peak:           " << std::setw(23) << open_list_peak << "|" << std::endl;
+    os << "|  Duplicate hits:           " << std::setw(23) << duplicate_hits << "|" << std::endl;
+    os << "|  Nodes pruned:             " << std::setw(23) << nodes_pruned << "|" << std::endl;
+    os << "|  Assignments enumerated:   " << std::setw(23) << assignments_enumerated << "|" << std::endl;
+    os << "|  Interaction nodes:        " << std::setw(23) << interaction_nodes << "|" << std::endl;
+    os << "|  Peak search memory [kB]:  " << std::setw(23) << peak_search_bytes / 1024 << "|" << std::endl;
+    os << "|  Nodes spilled:            " << std::setw(23) << nodes_spilled << "|" << std::endl;
+    os << "|  Spill written [kB]:       " << std::setw(23) << spill_bytes / 1024 << "|" << std::endl;
+    os << "|  Nodes forgotten:          " << std::setw(23) << nodes_forgotten << "|" << std::endl;
+    os << "|  Nodes dominated:          " << std::setw(23) << nodes_dominated << "|" << std::endl;
+    os << "+---------------------------------------------------+" << std::endl;
+    os << "|  Phase         Wall [ms]          CPU [ms]        |" << std::endl;
+    os << std::fixed << std::setprecision(3);
+    for (const auto &phase : phases)
+    {
+        os << "|  " << std::setw(12) << phase.name
+           << std::right << std::setw(11) << phase.wall_ms
+           << std::setw(18) << phase.cpu_ms
+           << std::left << std::setw(8) << "" << "|" << std::endl;
+    }
+    os << "+---------------------------------------------------+" << std::endl;
+    os << std::defaultfloat << std::right;
+}
+
+inline void SearchStatistics::writeJson(std::ostream &os) const
+{
+    os << "{" << std::endl;
+    os << "  \"nodes_generated\": " << nodes_generated << "," << std::endl;
+    os << "  \"nodes_expanded\": " << nodes_expanded << "," << std::endl;
+    os << "  \"open_list_peak\": " << open_list_peak << "," << std::endl;
+    os << "  \"duplicate_hits\": " << duplicate_hits << "," << std::endl;
+    os << "  \"nodes_pruned\": " << nodes_pruned << "," << std::endl;
+    os << "  \"assignments_enumerated\": " << assignments_enumerated << "," << std::endl;
+    os << "  \"interaction_nodes\": " << interaction_nodes << "," << std::endl;
+    os << "  \"peak_search_bytes\": " << peak_search_bytes << "," << std::endl;
+    os << "  \"nodes_spilled\": " << nodes_spilled << "," << std::endl;
+    os << "  \"spill_bytes\": " << spill_bytes << "," << std::endl;
+    os << "  \"nodes_forgotten\": " << nodes_forgotten << "," << std::endl;
+    os << "  \"nodes_dominated\": " << nodes_dominated << "," << std::endl;
+    os << "  \"phases\": {";
+    os << std::fixed << std::setprecision(3);
+    for (std::size_t i = 0; i < phases.size(); i++)
+    {
+        os << (i ? "," : "") << std::endl
+           << "    \"" << phases[i].name << "\": {\"wall_ms\": " << phases[i].wall_ms
+           << ", \"cpu_ms\": " << phases[i].cpu_ms << "}";
+    }
+    os << std::endl << "  }" << std::endl;
+    os << "}" << std::endl;
+    os << std::defaultfloat;
+}
+
+// Measures wall-clock and CPU time between construction and destruction,
+// and adds it to the named phase. A null statistics object disables the measurement.
+struct ScopedPhase
+{
+    ScopedPhase(SearchStatistics *, std::string);
+    ScopedPhase(const ScopedPhase &) = delete;
+    ~ScopedPhase();
+
+  private:
+    SearchStatistics *stats_;
+    std::string name_;
+    std::chrono::steady_clock::time_point wall_begin_;
+    std::clock_t cpu_begin_;
+};
+
+inline ScopedPhase::ScopedPhase(SearchStatistics *stats, std::string name)
+    : stats_(stats), name_(std::move(name))
+{
+    if (stats_ == nullptr)
+        return;
+    wall_begin_ = std::chrono::steady_clock::now();
+    cpu_begin_ = std::clock();
+}
+
+inline ScopedPhase::~ScopedPhase()
+{
+    if (stats_ == nullptr)
+        return;
+    double wall = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - wall_begin_).count();
+    double cpu = 1000.0 * (std::clock() - cpu_begin_) / CLOCKS_PER_SEC;
+    stats_->addPhase(name_, wall, cpu);
+}
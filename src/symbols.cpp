@@ -0,0 +1,64 @@
+#include <mutex>
+
+#include "symbols.hpp"
+
+SymbolTable &SymbolTable::instance()
+{
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::SymbolTable()
+{
+    intern("");
+}
+
+Symbol SymbolTable::intern(std::string_view name)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end())
+            return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // Another thread may have added the name between the two locks
+    auto it = ids_.find(name);
+    if (it != ids_.end())
+        return it->second;
+    Symbol id = Symbol(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+std::optional<Symbol> SymbolTable::find(std::string_view name) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it == ids_.end())
+        return std::nullopt;
+    return it->second;
+}
+
+const std::string &SymbolTable::name(Symbol id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.at(id);
+}
+
+std::size_t SymbolTable::size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return names_.size();
+}
+
+Symbol intern(std::string_view name)
+{
+    return SymbolTable::instance().intern(name);
+}
+
+const std::string &nameOf(Symbol id)
+{
+    return SymbolTable::instance().name(id);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned name of a node, action or agent
+using Symbol = std::uint32_t;
+
+// Process-wide table of the names of all assemblies read so far.
+// Names are interned once while the input is parsed; the planner only copies, compares and hashes
+// their ids, and the writers and debug printers resolve them back to strings. Ids are dense and
+// never reused, the empty name has the id 0.
+class SymbolTable
+{
+  public:
+    static SymbolTable &instance();
+
+    // Id of the name, which is added if it is not known yet
+    Symbol intern(std::string_view);
+    // Id of a name which was interned before, without adding it
+    std::optional<Symbol> find(std::string_view) const;
+    // Name of an id, the reference stays valid for the lifetime of the table
+    const std::string &name(Symbol) const;
+
+    std::size_t size() const;
+
+  private:
+    SymbolTable();
+
+    // Models may be read and planned on several threads at once
+    mutable std::shared_mutex mutex_;
+    // Names do not move when the deque grows, the keys of `ids_` point into them
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, Symbol> ids_;
+};
+
+// Shorthands for the process-wide table
+Symbol intern(std::string_view);
+const std::string &nameOf(Symbol);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool executing tasks in submission order.
+// Tasks must not block on other tasks of the same pool; callers schedule dependent work
+// only once its inputs are available.
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(std::size_t threads);
+    ThreadPool(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    template <typename F>
+    auto submit(F &&task) -> std::future<decltype(task())>;
+
+    std::size_t size() const;
+
+  private:
+    void worker();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
+
+inline ThreadPool::ThreadPool(std::size_t threads)
+{
+    for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); i++)
+        workers_.emplace_back(&ThreadPool::worker, this);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &w : workers_)
+        w.join();
+}
+
+template <typename F>
+auto ThreadPool::submit(F &&task) -> std::future<decltype(task())>
+{
+    using R = decltype(task());
+    auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    auto future = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back([packaged]() { (*packaged)(); });
+    }
+    cv_.notify_one();
+    return future;
+}
+
+inline std::size_t ThreadPool::size() const
+{
+    return workers_.size();
+}
+
+inline void ThreadPool::worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_ && queue_.empty())
+                return;
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Chrome trace-event output (chrome://tracing, Perfetto).
+// Spans are compiled in unless PLANNER_TRACING is defined as 0. When compiled in, recording is
+// switched on at runtime with `Tracer::instance().enable()`; a disabled span costs a single
+// relaxed atomic load.
+#ifndef PLANNER_TRACING
+#define PLANNER_TRACING 1
+#endif
+
+// Complete ("X") event: a named span with start time and duration in microseconds
+struct TraceEvent
+{
+    const char *name;
+    const char *category;
+    int64_t begin_us;
+    int64_t duration_us;
+    uint32_t thread;
+};
+
+class Tracer
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static Tracer &instance();
+
+    void enable();
+    bool enabled() const;
+
+    // Record a finished span. Names must be string literals, they are stored by pointer.
+    void record(const char *, const char *, Clock::time_point, Clock::time_point);
+    // Write all recorded events as trace-event JSON
+    bool write(const std::string &) const;
+
+  private:
+    Tracer();
+    static uint32_t threadIndex();
+
+    std::atomic<bool> enabled_;
+    Clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<TraceEvent> events_;
+};
+
+inline Tracer &Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+inline Tracer::Tracer()
+    : enabled_(false), origin_(Clock::now())
+{}
+
+inline void Tracer::enable()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.reserve(1 << 14);
+    origin_ = Clock::now();
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+inline bool Tracer::enabled() const
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+// Small sequential thread ids are easier to read in the trace viewer than native handles
+inline uint32_t Tracer::threadIndex()
+{
+    static std::atomic<uint32_t> counter{0};
+    thread_local uint32_t index = counter++;
+    return index;
+}
+
+inline void Tracer::record(const char *name, const char *category,
+                           Clock::time_point begin, Clock::time_point end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    TraceEvent event{name, category,
+                     duration_cast<microseconds>(begin - origin_).count(),
+                     duration_cast<microseconds>(end - begin).count(),
+                     threadIndex()};
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(event);
+}
+
+inline bool Tracer::write(const std::string &path) const
+{
+    std::ofstream fs(path);
+    if (!fs)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    fs << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (std::size_t i = 0; i < events_.size(); i++)
+    {
+        const auto &e = events_[i];
+        fs << (i ? "," : "") << std::endl
+           << "  {\"name\": \"" << e.name << "\", \"cat\": \"" << e.category
+           << "\", \"ph\": \"X\", \"ts\": " << e.begin_us << ", \"dur\": " << e.duration_us
+           << ", \"pid\": 1, \"tid\": " << e.thread << "}";
+    }
+    fs << std::endl << "]}" << std::endl;
+    return fs.good();
+}
+
+// Records the time between construction and destruction as one span
+struct TraceSpan
+{
+    TraceSpan(const char *, const char * = "planner");
+    TraceSpan(const TraceSpan &) = delete;
+    ~TraceSpan();
+
+  private:
+    const char *name_;
+    const char *category_;
+    bool active_;
+    Tracer::Clock::time_point begin_;
+};
+
+inline TraceSpan::TraceSpan(const char *name, const char *category)
+    : name_(name), category_(category), active_(Tracer::instance().enabled())
+{
+    if (active_)
+        begin_ = Tracer::Clock::now();
+}
+
+inline TraceSpan::~TraceSpan()
+{
+    if (active_)
+        Tracer::instance().record(name_, category_, begin_, Tracer::Clock::now());
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#if PLANNER_TRACING
+#define TRACE_SCOPE(...) TraceSpan TRACE_CONCAT(trace_span_, __LINE__)(__VA_ARGS__)
+#else
+#define TRACE_SCOPE(...)
+#endif
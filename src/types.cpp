@@ -0,0 +1,27 @@
+#include <sstream>
+
+#include "types.hpp"
+
+bool is_float(std::string my_string)
+{
+    std::istringstream iss(my_string);
+    float f;
+    iss >> std::noskipws >> f;
+    return iss.eof() && !iss.fail();
+}
+
+std::string nodeName(const AssemblyData& data)
+{
+    if (data.type == NodeType::INTERASSEMBLY)
+        return nameOf(data.name) + "′";
+    return nameOf(data.name);
+}
+
+// splitmix64: a bijection on 64-bit integers, so distinct nodes never share a key
+std::uint64_t zobristKey(NodeIndex id)
+{
+    std::uint64_t z = std::uint64_t(id) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
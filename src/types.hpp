@@ -1,33 +1,37 @@
 #pragma once
 
+#include <cstdint>
 #include <ostream>
 #include <vector>
 #include <unordered_map>
 #include <cmath>
 #include <iomanip>
+#include <string>
+
+#include "persistent_map.hpp"
+#include "symbols.hpp"
 
 using NodeIndex = size_t;
 using EdgeIndex = size_t;
 
 struct AgentActionAssignment
 {
-    std::string agent;
-    std::string action;
+    Symbol agent;
+    Symbol action;
     size_t action_node_id;
 };
 
+// State of a hypernode: the open subassemblies and the actions available on them
 struct SearchData
 {
-    bool marked = false;
-
-    double g_score = 0;
-    double f_score = 0;
-    double h_score = 0;
-
+    // Cheapest cost of any agent for any available action, used by the heuristic
     double minimum_cost_action = MAXFLOAT;
+    // Zobrist hash: XOR of the keys of the graph nodes in `subassemblies` and `actions`
+    std::uint64_t hash = 0;
 
-    std::unordered_map<std::string, size_t> subassemblies;
-    std::unordered_map<std::string, size_t> actions;
+    // Children share the unchanged parts of the maps with their parent, see `PersistentMap`
+    PersistentMap subassemblies;
+    PersistentMap actions;
 };
 
 enum class NodeType
@@ -41,10 +45,13 @@ enum class NodeType
 struct AssemblyData
 {
     NodeType type;
-    std::string name = "";
+    // Interassemblies share the name of the subassembly they hand over, see `nodeName`
+    Symbol name = 0;
+    // Zobrist key of the node, see `zobristKey`
+    std::uint64_t key = 0;
     
     // Only utilized for ACTION type nodes
-    std::string assigned_agent;
+    Symbol assigned_agent = 0;
     size_t interaction_prev;
     size_t interaction_or;
     size_t interaction_next;
@@ -61,17 +68,17 @@ namespace config
 
     struct Action
     {
-        using agentname = std::string;
+        using agentname = Symbol;
         
-        std::string name;
+        Symbol name = 0;
         std::unordered_map<agentname, double> costs;
 
         friend std::ostream &operator<<(std::ostream &os, const Action &a)
         {
-            os << "| Action " << std::setw(5) << a.name << std::setw(29) << "|" << std::endl;
+            os << "| Action " << std::setw(5) << nameOf(a.name) << std::setw(29) << "|" << std::endl;
             for(const auto &cost_agent : a.costs)
             {
-                os << "|    Agent: " << std::setw(4)  << cost_agent.first 
+                os << "|    Agent: " << std::setw(4)  << nameOf(cost_agent.first)
                     << "    Cost"    << std::setw(15) << cost_agent.second 
                     << std::setw(4)  << "|" <<std::endl;
             }
@@ -88,22 +95,22 @@ namespace config
         {
             os << "   Reachable: " <<  r.reachable << "     "
                 << "Interaction: " << std::setw(2) 
-                 << r.interaction.name << "  |" << std::endl;
+                 << nameOf(r.interaction.name) << "  |" << std::endl;
             return os;
         }
     };
 
     struct Subassembly
     {
-        std::string name;
-        std::unordered_map<std::string, Reach> reachability;
+        Symbol name = 0;
+        std::unordered_map<Symbol, Reach> reachability;
 
         friend std::ostream &operator<<(std::ostream &os, const Subassembly &s)
         {
-            os << "| " << std::setw(51) << std::left << s.name << "|" << std::endl;
+            os << "| " << std::setw(51) << std::left << nameOf(s.name) << "|" << std::endl;
             for(const auto &agent_reach : s.reachability)
             {
-                os << "|    Agent: " << std::setw(4) << agent_reach.first
+                os << "|    Agent: " << std::setw(4) << nameOf(agent_reach.first)
                     << agent_reach.second;
             }
             return os;
@@ -112,13 +119,13 @@ namespace config
 
     struct Agent
     {
-        std::string name;
+        Symbol name = 0;
         std::string hostname;
         std::string port;
 
         friend std::ostream &operator<<(std::ostream &os, const Agent &a)
         {
-            os << "Name: " << std::setw(4)   << a.name     << " | "
+            os << "Name: " << std::setw(4)   << nameOf(a.name) << " | "
                << "Host: "   << std::setw(15)  << a.hostname << " | "
                << "Port: "   << std::setw(5)   << a.port;
             return os;
@@ -127,9 +134,9 @@ namespace config
 
     struct Configuration
     {
-        std::unordered_map<std::string, Agent> agents;
-        std::unordered_map<std::string, Action> actions;
-        std::unordered_map<std::string, Subassembly> subassemblies;
+        std::unordered_map<Symbol, Agent> agents;
+        std::unordered_map<Symbol, Action> actions;
+        std::unordered_map<Symbol, Subassembly> subassemblies;
 
         friend std::ostream &operator<<(std::ostream &os, const Configuration &c)
         {
@@ -164,10 +171,11 @@ namespace config
     };
 }
 
-bool is_float(std::string my_string)
-{
-    std::istringstream iss(my_string);
-    float f;
-    iss >> std::noskipws >> f;
-    return iss.eof() && !iss.fail();
-}
+// Random 64-bit key of the graph node with the given index, assigned when the node is inserted.
+// The keys of the nodes of a state are combined into `SearchData::hash`.
+std::uint64_t zobristKey(NodeIndex);
+
+// Name of a graph node as written to plans, interassemblies are marked with a prime
+std::string nodeName(const AssemblyData&);
+
+bool is_float(std::string);
@@ -0,0 +1,194 @@
+#include <chrono>
+#include <climits>
+#include <iostream>
+
+#include "planner.hpp"
+#include "generator.hpp"
+
+// Regression checks on generated assemblies: ./planner_check, returns 1 if a check fails.
+
+// Plans of the A* search after `applyProgress` must not be worse than the AO* plan. The completed
+// subassemblies are leaves with long names, which once gave every goal an h score near MAXFLOAT.
+// The default heuristic is not admissible, so the instances are fixed.
+static bool checkProgress()
+{
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 9; seed++)
+    {
+        for (std::size_t parts : {5, 6})
+        {
+            AssemblySpec spec;
+            spec.parts = parts;
+            spec.agents = 2;
+            spec.seed = seed;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+
+            ExecutionProgress progress;
+            progress.completed.push_back(intern("ABC"));
+            if (!applyProgress(assembly, progress))
+                return false;
+            double aostar = AOStarSolver(assembly, config).solve().roundCost(config);
+
+            // Without the incumbent bound, and exact with the admissible bound of the focal search
+            for (double suboptimality : {1.0, 1.000000001})
+            {
+                PlannerOptions options;
+                options.print = false;
+                options.prune = false;
+                options.suboptimality = suboptimality;
+                Planner planner(options);
+                auto copy = config;
+                planner(assembly, copy);
+                double astar = planner.plans.front().roundCost(copy);
+                if (astar > aostar + 1e-9)
+                {
+                    std::cerr << "CHECK ERROR: progress seed=" << seed << " parts=" << parts
+                              << " suboptimality=" << suboptimality << ": A* " << astar
+                              << " exceeds AO* " << aostar << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+// The incumbent bound must not discard a plan the search finds without it. Pruning on the f score once
+// returned the greedy plan for seed 10 with 5 parts instead of the plan costing 66.5.
+static bool checkPrune()
+{
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 12; seed++)
+    {
+        for (std::size_t parts : {5, 6})
+        {
+            AssemblySpec spec;
+            spec.parts = parts;
+            spec.agents = 2;
+            spec.seed = seed;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+
+            double cost[2];
+            for (bool prune : {false, true})
+            {
+                PlannerOptions options;
+                options.print = false;
+                options.prune = prune;
+                Planner planner(options);
+                auto copy = config;
+                planner(assembly, copy);
+                cost[prune] = planner.plans.front().roundCost(copy);
+            }
+            if (cost[1] > cost[0] + 1e-9)
+            {
+                std::cerr << "CHECK ERROR: prune seed=" << seed << " parts=" << parts << ": " << cost[1]
+                          << " exceeds " << cost[0] << " without pruning" << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+// SMA* must terminate at budgets below the peak of the unbounded search, with a plan not cheaper than the
+// optimum. Subtrees of equal f score once evicted each other forever at a quarter of it (seed 2, 6 parts).
+static bool checkMemoryLimit()
+{
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 10; seed++)
+    {
+        for (std::size_t parts : {5, 6})
+        {
+            AssemblySpec spec;
+            spec.parts = parts;
+            spec.agents = 2;
+            spec.seed = seed;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+
+            PlannerOptions unbounded;
+            unbounded.print = false;
+            unbounded.memory_limit = std::size_t(1) << 40;
+            Planner reference(unbounded);
+            auto copy = config;
+            reference(assembly, copy);
+            double optimum = reference.plans.front().roundCost(copy);
+            std::size_t peak = reference.statistics.peak_search_bytes;
+
+            for (double fraction : {0.5, 0.25, 0.1})
+            {
+                PlannerOptions options;
+                options.print = false;
+                options.memory_limit = std::size_t(peak * fraction);
+                options.control.deadline = PlanningControl::Clock::now() + std::chrono::seconds(10);
+                Planner planner(options);
+                copy = config;
+                planner(assembly, copy);
+                double cost = planner.plans.front().roundCost(copy);
+                if (planner.status != PlanningStatus::COMPLETE || cost < optimum - 1e-9)
+                {
+                    std::cerr << "CHECK ERROR: memory seed=" << seed << " parts=" << parts << " budget="
+                              << options.memory_limit << ": " << cost << " after " << planner.statistics.nodes_expanded
+                              << " expansions, optimum " << optimum << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+// A search stopped before its first goal returns the best known plan: it must not cost more than the AO*
+// plan, and the greedy plan must avoid infeasible assignments where the AO* plan does. The greedy choice
+// once led seed 9 with 6 parts into actions costing INT_MAX only.
+static bool checkFallback()
+{
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 12; seed++)
+    {
+        for (std::size_t parts : {5, 6})
+        {
+            AssemblySpec spec;
+            spec.parts = parts;
+            spec.agents = 2;
+            spec.seed = seed;
+            Graph<AssemblyData, EdgeData> assembly;
+            config::Configuration config;
+            AssemblyGenerator(spec).generate(assembly, config);
+
+            double greedy = GreedyPlanner(assembly, config).solve().roundCost(config);
+            double aostar = AOStarSolver(assembly, config).solve().roundCost(config);
+
+            PlannerOptions options;
+            options.print = false;
+            options.prune = false;
+            options.control.token.cancel();
+            Planner planner(options);
+            auto copy = config;
+            planner(assembly, copy);
+            double cost = planner.plans.front().roundCost(copy);
+            if (cost > aostar + 1e-9 || (greedy >= INT_MAX && aostar < INT_MAX))
+            {
+                std::cerr << "CHECK ERROR: fallback seed=" << seed << " parts=" << parts << ": " << cost
+                          << ", greedy " << greedy << ", AO* " << aostar << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+int main()
+{
+    bool ok = true;
+    ok &= checkProgress();
+    ok &= checkPrune();
+    ok &= checkMemoryLimit();
+    ok &= checkFallback();
+    return ok ? 0 : 1;
+}